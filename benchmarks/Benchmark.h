@@ -0,0 +1,53 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+
+namespace U8W::Benchmark
+{
+
+// Calls the function with the iteration index and returns the average
+// duration of a call in nanoseconds
+template <typename Function>
+double measure(const int iterations, Function&& function)
+{
+    const auto start = std::chrono::steady_clock::now();
+
+    for (auto i = 0; i < iterations; ++i) {
+        function(i);
+    }
+
+    const auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / iterations;
+}
+
+// Keeps the compiler from optimizing away a result
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void printHeader(const char* title)
+{
+    std::printf("\n%s\n", title);
+}
+
+}
@@ -0,0 +1,114 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+// Compares the XBM blitter of Display with u8g2_DrawXBM() for
+// full-screen and icon sized bitmaps
+
+#include "Benchmark.h"
+#include "Display.h"
+#include "HeadlessBackend.h"
+#include "U8g2Reference.h"
+
+#include <cstdio>
+#include <initializer_list>
+#include <vector>
+
+using namespace U8W;
+
+namespace
+{
+
+struct Case
+{
+    const char* name;
+    int width;
+    int height;
+    int x;
+    int y;
+    int iterations;
+    bool clipped;
+};
+
+std::vector<uint8_t> makeBitmap(const int width, const int height)
+{
+    std::vector<uint8_t> data(((width + 7) / 8) * height);
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 37 + 11);
+    }
+
+    return data;
+}
+
+}
+
+int main()
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+    Benchmark::U8g2Reference reference;
+
+    const Case cases[] = {
+        { "full screen", 240, 160, 0, 0, 2000, false },
+        { "icon aligned", 16, 16, 64, 40, 200000, false },
+        { "icon unaligned", 16, 16, 67, 40, 200000, false },
+        { "icon 13x11", 13, 11, 67, 41, 200000, false },
+        { "icon clipped", 16, 16, 92, 40, 200000, true },
+    };
+
+    Benchmark::printHeader("Blit benchmark, ns per bitmap");
+    std::printf(
+        "%-16s %-8s %14s %14s %8s\n",
+        "bitmap", "mode", "u8g2_DrawXBM", "Display", "speedup"
+    );
+
+    for (const auto& c : cases) {
+        const auto bitmap = makeBitmap(c.width, c.height);
+
+        if (c.clipped) {
+            display.setClipRect(Rect{ 0, 0, 100, 50 });
+            u8g2_SetClipWindow(reference.get(), 0, 0, 100, 50);
+        } else {
+            display.resetClipRect();
+            u8g2_SetMaxClipWindow(reference.get());
+        }
+
+        for (const auto inverted : { false, true }) {
+            const auto color = inverted ? Color::White : Color::Black;
+            display.setDrawColor(color);
+            u8g2_SetDrawColor(reference.get(), static_cast<uint8_t>(color));
+
+            const auto u8g2Ns = Benchmark::measure(c.iterations, [&](int) {
+                u8g2_DrawXBM(reference.get(), c.x, c.y, c.width, c.height, bitmap.data());
+            });
+
+            const auto displayNs = Benchmark::measure(c.iterations, [&](int) {
+                display.drawBitmap(Point{ c.x, c.y }, c.width, c.height, bitmap.data());
+            });
+
+            std::printf(
+                "%-16s %-8s %14.1f %14.1f %7.1fx\n",
+                c.name,
+                inverted ? "inverted" : "normal",
+                u8g2Ns,
+                displayNs,
+                u8g2Ns / displayNs
+            );
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+// Compares the fill kernel of Display with u8g2_DrawBox() for several
+// rectangle sizes and alignments
+
+#include "Benchmark.h"
+#include "Display.h"
+#include "HeadlessBackend.h"
+#include "U8g2Reference.h"
+#include "Utils.h"
+
+#include <cstdio>
+
+using namespace U8W;
+
+namespace
+{
+
+constexpr auto Pixels = 20'000'000;
+
+}
+
+int main()
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+    Benchmark::U8g2Reference reference;
+
+    const Rect rects[] = {
+        Rect{ 0, 0, 240, 160 },
+        Rect{ 0, 16, 120, 72 },
+        Rect{ 3, 17, 117, 71 },
+        Rect{ 32, 40, 64, 16 },
+        Rect{ 37, 40, 50, 12 },
+        Rect{ 100, 80, 8, 8 },
+        Rect{ 101, 80, 5, 3 },
+    };
+
+    const Color colors[] = { Color::Black, Color::White, Color::Xor };
+    const char* const colorNames[] = { "set", "clear", "xor" };
+
+    Benchmark::printHeader("Fill benchmark, ns per rectangle");
+    std::printf(
+        "%-20s %-6s %12s %12s %8s\n",
+        "rect", "color", "u8g2_DrawBox", "Display", "speedup"
+    );
+
+    for (const auto& rect : rects) {
+        const auto iterations = Utils::max(Pixels / (rect.width() * rect.height()), 1000);
+
+        char name[32];
+        std::snprintf(
+            name, sizeof(name), "%dx%d at %d,%d",
+            rect.width(), rect.height(), rect.x(), rect.y()
+        );
+
+        for (auto c = 0; c < 3; ++c) {
+            display.setDrawColor(colors[c]);
+            u8g2_SetDrawColor(reference.get(), static_cast<uint8_t>(colors[c]));
+
+            const auto u8g2Ns = Benchmark::measure(iterations, [&](int) {
+                u8g2_DrawBox(reference.get(), rect.x(), rect.y(), rect.width(), rect.height());
+            });
+
+            const auto displayNs = Benchmark::measure(iterations, [&](int) {
+                display.fillRect(rect);
+            });
+
+            std::printf(
+                "%-20s %-6s %12.1f %12.1f %7.1fx\n",
+                name,
+                colorNames[c],
+                u8g2Ns,
+                displayNs,
+                u8g2Ns / displayNs
+            );
+        }
+    }
+
+    return 0;
+}
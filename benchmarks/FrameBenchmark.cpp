@@ -0,0 +1,204 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+// Builds a representative screen on the headless display, mutates it in
+// typical patterns and reports the cost of a frame, the pixels touched
+// and the bytes sent to the panel.
+
+#include "Arena.h"
+#include "Benchmark.h"
+#include "Display.h"
+#include "Font.h"
+#include "HeadlessBackend.h"
+#include "Image.h"
+#include "Label.h"
+#include "Painter.h"
+#include "Widget.h"
+
+#include <array>
+#include <cstdio>
+#include <functional>
+#include <memory>
+
+using namespace U8W;
+
+namespace
+{
+
+constexpr auto Frames = 2000;
+
+// 16x16 XBM icon
+const unsigned char Icon[] = {
+    0xff, 0xff, 0x01, 0x80, 0xfd, 0xbf, 0x05, 0xa0,
+    0xf5, 0xaf, 0x15, 0xa8, 0xd5, 0xab, 0x55, 0xaa,
+    0x55, 0xaa, 0xd5, 0xab, 0x15, 0xa8, 0xf5, 0xaf,
+    0x05, 0xa0, 0xfd, 0xbf, 0x01, 0x80, 0xff, 0xff
+};
+
+// Four panels with a title, six values and two icons each, and a status
+// bar with a clock and icons
+class Screen
+{
+public:
+    static constexpr auto Panels = 4;
+    static constexpr auto ValuesPerPanel = 6;
+
+    explicit Screen(Display& display)
+        : root{ &display }
+    {
+        root.setName("root");
+        root.setRect(Rect{ Point{}, display.size() });
+
+        auto* const statusBar = _arena.create<Widget>(&root);
+        statusBar->setName("statusBar");
+        statusBar->setRect(Rect{ 0, 0, 240, 16 });
+
+        clock = _arena.create<Label>("12:00:00", statusBar);
+        clock->setName("clock");
+        clock->setFont(Font{ Font::Family::Pxl16x8_Mono });
+        clock->setRect(Rect{ 2, 1, 80, 14 });
+        clock->setIncrementalRedrawEnabled(true);
+
+        for (auto i = 0; i < 4; ++i) {
+            auto* const icon = _arena.create<Image>(Icon, 16, 16, statusBar);
+            icon->setPos(Point{ 160 + i * 20, 0 });
+        }
+
+        for (auto p = 0; p < Panels; ++p) {
+            auto* const panel = _arena.create<Widget>(&root);
+            panel->setName("panel");
+            panel->setRect(Rect{ (p % 2) * 120, 16 + (p / 2) * 72, 120, 72 });
+            panels[p] = panel;
+
+            auto* const title = _arena.create<Label>("Panel", panel);
+            title->setRect(Rect{ 2, 0, 80, 10 });
+
+            for (auto i = 0; i < 2; ++i) {
+                auto* const icon = _arena.create<Image>(Icon, 16, 16, panel);
+                icon->setPos(Point{ 84 + i * 18, 0 });
+            }
+
+            for (auto v = 0; v < ValuesPerPanel; ++v) {
+                auto* const value = _arena.create<Label>(panel);
+                value->setName("value");
+                value->setFont(Font{ Font::Family::Pxl16x8 });
+                value->setRect(Rect{ 2 + (v % 2) * 58, 16 + (v / 2) * 18, 56, 16 });
+                value->setAlignment(Align::Right);
+                value->setNumber(v);
+                values[p * ValuesPerPanel + v] = value;
+            }
+        }
+    }
+
+    // Destroyed after the arena, which holds its children
+    Widget root;
+
+    Label* clock = nullptr;
+    std::array<Widget*, Panels> panels{};
+    std::array<Label*, Panels * ValuesPerPanel> values{};
+
+private:
+    StaticArena<64 * 1024> _arena;
+};
+
+struct Scenario
+{
+    const char* name;
+    std::function<void(Screen&, int)> mutate;
+};
+
+void run(
+    const Scenario& scenario,
+    const Painter::RepaintMode mode,
+    HeadlessBackend& backend,
+    Display& display
+)
+{
+    auto screen = std::make_unique<Screen>(display);
+
+    Painter painter;
+    painter.setRepaintMode(mode);
+
+    // The first frame paints everything
+    painter.paintWidget(&screen->root);
+
+    display.resetDrawStatistics();
+    painter.resetStatistics();
+    const auto bytesBefore = backend.transportStatistics().bytes;
+
+    auto screenPtr = screen.get();
+
+    const auto ns = Benchmark::measure(Frames, [&](const int frame) {
+        scenario.mutate(*screenPtr, frame);
+        painter.paintWidget(&screenPtr->root);
+    });
+
+    const auto bytes = backend.transportStatistics().bytes - bytesBefore;
+
+    std::printf(
+        "%-14s %-7s %10.0f %12.0f %10u %10u %8.1f\n",
+        scenario.name,
+        mode == Painter::RepaintMode::Full ? "full" : "damage",
+        1e9 / ns,
+        ns,
+        display.drawStatistics().pixelsTouched / Frames,
+        bytes / Frames,
+        static_cast<double>(painter.statistics().paints) / Frames
+    );
+}
+
+}
+
+int main()
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+
+    const Scenario scenarios[] = {
+        { "idle", [](Screen&, int) {} },
+        { "one value", [](Screen& s, const int frame) {
+            s.values[0]->setNumber(frame);
+        } },
+        { "all values", [](Screen& s, const int frame) {
+            for (auto* value : s.values) {
+                value->setNumber(frame);
+            }
+        } },
+        { "clock", [](Screen& s, const int frame) {
+            s.clock->setNumber(frame % 1'000'000, NumberFormat{ 8, '0' });
+        } },
+        { "panel move", [](Screen& s, const int frame) {
+            s.panels[1]->setPos(Point{ 120 + frame % 2, 16 });
+        } },
+        { "full repaint", [](Screen& s, int) {
+            s.root.setBackgroundEnabled(true);
+        } },
+    };
+
+    Benchmark::printHeader("Frame benchmark, headless 240x160 display");
+    std::printf(
+        "%-14s %-7s %10s %12s %10s %10s %8s\n",
+        "scenario", "mode", "frames/s", "ns/paint", "pixels", "bytes", "paints"
+    );
+
+    for (const auto& scenario : scenarios) {
+        for (const auto mode : { Painter::RepaintMode::Full, Painter::RepaintMode::Damage }) {
+            run(scenario, mode, backend, display);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+// Compares repainting only the changed glyph cells of monospace labels
+// with repainting the whole labels, for counters of which mostly the
+// last digit changes
+
+#include "Benchmark.h"
+#include "Display.h"
+#include "Font.h"
+#include "HeadlessBackend.h"
+#include "Label.h"
+#include "NumberFormat.h"
+#include "Painter.h"
+#include "Widget.h"
+
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace U8W;
+
+namespace
+{
+
+constexpr auto Frames = 2000;
+constexpr auto Labels = 16;
+
+struct Result
+{
+    double ns = 0;
+    uint32_t pixels = 0;
+    uint32_t tiles = 0;
+};
+
+Result run(Display& display, const Font& font, const bool incremental)
+{
+    Widget root{ &display };
+    root.setRect(Rect{ Point{}, display.size() });
+
+    std::vector<std::unique_ptr<Label>> labels;
+
+    for (auto i = 0; i < Labels; ++i) {
+        auto label = std::make_unique<Label>(&root);
+        label->setFont(font);
+        label->setPos(Point{ (i % 2) * 120, (i / 2) * 20 });
+        label->setWidth(116);
+        label->setAlignment(Align::Right);
+        label->setIncrementalRedrawEnabled(incremental);
+        label->setNumber(i * 1000, NumberFormat{ 6, ' ' });
+        labels.push_back(std::move(label));
+    }
+
+    Painter painter;
+    painter.paintWidget(&root);
+
+    display.resetDrawStatistics();
+    display.resetUpdateStatistics();
+
+    Result result;
+
+    result.ns = Benchmark::measure(Frames, [&](const int frame) {
+        for (auto i = 0; i < Labels; ++i) {
+            labels[i]->setNumber(i * 1000 + frame + 1, NumberFormat{ 6, ' ' });
+        }
+
+        painter.paintWidget(&root);
+    });
+
+    result.pixels = display.drawStatistics().pixelsTouched / Frames;
+    result.tiles = display.updateStatistics().tilesSent / Frames;
+
+    labels.clear();
+
+    return result;
+}
+
+}
+
+int main()
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+
+    Benchmark::printHeader("Label repaint benchmark, 16 counting labels, per frame");
+    std::printf(
+        "%-16s %-12s %10s %10s %8s\n",
+        "font", "repaint", "ns", "pixels", "tiles"
+    );
+
+    const struct
+    {
+        const char* name;
+        Font::Family family;
+    } fonts[] = {
+        { "Pxl16x8_Mono", Font::Family::Pxl16x8_Mono },
+        { "BitCellMonoNum", Font::Family::BitCellMonoNumbers }
+    };
+
+    for (const auto& font : fonts) {
+        const auto full = run(display, Font{ font.family }, false);
+        const auto incremental = run(display, Font{ font.family }, true);
+
+        std::printf(
+            "%-16s %-12s %10.0f %10u %8u\n",
+            font.name, "full", full.ns, full.pixels, full.tiles
+        );
+        std::printf(
+            "%-16s %-12s %10.0f %10u %8u\n",
+            font.name, "incremental", incremental.ns, incremental.pixels, incremental.tiles
+        );
+        std::printf("%-16s %-12s %9.1fx\n", font.name, "speedup", full.ns / incremental.ns);
+    }
+
+    return 0;
+}
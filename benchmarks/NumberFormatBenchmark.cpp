@@ -0,0 +1,159 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+// Compares formatNumber() and formatFixedPoint() with std::to_string()
+// and snprintf() for the texts of labels and progress bars
+
+#include "Benchmark.h"
+#include "NumberFormat.h"
+
+#include <cstdio>
+#include <string>
+
+using namespace U8W;
+
+namespace
+{
+
+constexpr auto Iterations = 2'000'000;
+
+// Values of a typical range, including negative ones
+int32_t value(const int i)
+{
+    return static_cast<int32_t>((static_cast<uint32_t>(i) * 7919u) % 200'001u) - 100'000;
+}
+
+void report(const char* name, const double toStringNs, const double snprintfNs, const double formatNs)
+{
+    std::printf(
+        "%-22s %14.1f %10.1f %14.1f %8.1fx\n",
+        name,
+        toStringNs,
+        snprintfNs,
+        formatNs,
+        toStringNs / formatNs
+    );
+}
+
+}
+
+int main()
+{
+    char buffer[32];
+
+    Benchmark::printHeader("Number formatting benchmark, ns per call");
+    std::printf(
+        "%-22s %14s %10s %14s %8s\n",
+        "text", "std::to_string", "snprintf", "formatNumber", "speedup"
+    );
+
+    // ProgressBar text, e.g. "42%"
+    {
+        const auto toStringNs = Benchmark::measure(Iterations, [&](const int i) {
+            const auto text = std::to_string(i % 101) + '%';
+            Benchmark::doNotOptimize(text.data());
+        });
+
+        const auto snprintfNs = Benchmark::measure(Iterations, [&](const int i) {
+            std::snprintf(buffer, sizeof(buffer), "%d%%", i % 101);
+            Benchmark::doNotOptimize(buffer);
+        });
+
+        const auto formatNs = Benchmark::measure(Iterations, [&](const int i) {
+            formatNumber(buffer, sizeof(buffer), i % 101, NumberFormat{ 0, ' ', "%" });
+            Benchmark::doNotOptimize(buffer);
+        });
+
+        report("percent", toStringNs, snprintfNs, formatNs);
+    }
+
+    // Plain integer label
+    {
+        const auto toStringNs = Benchmark::measure(Iterations, [&](const int i) {
+            const auto text = std::to_string(value(i));
+            Benchmark::doNotOptimize(text.data());
+        });
+
+        const auto snprintfNs = Benchmark::measure(Iterations, [&](const int i) {
+            std::snprintf(buffer, sizeof(buffer), "%d", value(i));
+            Benchmark::doNotOptimize(buffer);
+        });
+
+        const auto formatNs = Benchmark::measure(Iterations, [&](const int i) {
+            formatNumber(buffer, sizeof(buffer), value(i));
+            Benchmark::doNotOptimize(buffer);
+        });
+
+        report("integer", toStringNs, snprintfNs, formatNs);
+    }
+
+    // Padded integer with a unit, e.g. "  -42 ms". std::to_string has no
+    // padding, it is added by hand.
+    {
+        const auto toStringNs = Benchmark::measure(Iterations, [&](const int i) {
+            auto text = std::to_string(value(i) / 100);
+            if (text.size() < 5) {
+                text.insert(0, 5 - text.size(), ' ');
+            }
+            text += " ms";
+            Benchmark::doNotOptimize(text.data());
+        });
+
+        const auto snprintfNs = Benchmark::measure(Iterations, [&](const int i) {
+            std::snprintf(buffer, sizeof(buffer), "%5d ms", value(i) / 100);
+            Benchmark::doNotOptimize(buffer);
+        });
+
+        const auto formatNs = Benchmark::measure(Iterations, [&](const int i) {
+            formatNumber(buffer, sizeof(buffer), value(i) / 100, NumberFormat{ 5, ' ', " ms" });
+            Benchmark::doNotOptimize(buffer);
+        });
+
+        report("padded with unit", toStringNs, snprintfNs, formatNs);
+    }
+
+    // Fixed point, e.g. "-12.34 V"
+    {
+        const auto toStringNs = Benchmark::measure(Iterations, [&](const int i) {
+            const auto v = value(i);
+            auto fraction = std::to_string((v < 0 ? -v : v) % 100);
+            if (fraction.size() < 2) {
+                fraction.insert(0, 1, '0');
+            }
+            const auto text =
+                (v < 0 && v > -100 ? "-" : "") + std::to_string(v / 100) + '.' + fraction + " V";
+            Benchmark::doNotOptimize(text.data());
+        });
+
+        const auto snprintfNs = Benchmark::measure(Iterations, [&](const int i) {
+            const auto v = value(i);
+            std::snprintf(
+                buffer, sizeof(buffer), "%s%d.%02d V",
+                v < 0 && v > -100 ? "-" : "", v / 100, (v < 0 ? -v : v) % 100
+            );
+            Benchmark::doNotOptimize(buffer);
+        });
+
+        const auto formatNs = Benchmark::measure(Iterations, [&](const int i) {
+            formatFixedPoint(buffer, sizeof(buffer), value(i), 2, NumberFormat{ 0, ' ', " V" });
+            Benchmark::doNotOptimize(buffer);
+        });
+
+        report("fixed point", toStringNs, snprintfNs, formatNs);
+    }
+
+    return 0;
+}
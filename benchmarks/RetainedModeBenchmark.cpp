@@ -0,0 +1,128 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+// Compares replaying the retained display lists of Labels and Images
+// with running their paint() when their parent is repainted
+
+#include "Benchmark.h"
+#include "Display.h"
+#include "Font.h"
+#include "HeadlessBackend.h"
+#include "Image.h"
+#include "Label.h"
+#include "Painter.h"
+#include "Widget.h"
+
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+using namespace U8W;
+
+namespace
+{
+
+constexpr auto Iterations = 5000;
+constexpr auto Children = 24;
+
+const unsigned char Icon[] = {
+    0xff, 0xff, 0x01, 0x80, 0xfd, 0xbf, 0x05, 0xa0,
+    0xf5, 0xaf, 0x15, 0xa8, 0xd5, 0xab, 0x55, 0xaa,
+    0x55, 0xaa, 0xd5, 0xab, 0x15, 0xa8, 0xf5, 0xaf,
+    0x05, 0xa0, 0xfd, 0xbf, 0x01, 0x80, 0xff, 0xff
+};
+
+enum class Kind
+{
+    Label,
+    Image
+};
+
+double run(Display& display, const Kind kind, const bool retained, uint32_t& replays)
+{
+    Widget root{ &display };
+    root.setRect(Rect{ Point{}, display.size() });
+
+    std::vector<std::unique_ptr<Widget>> children;
+
+    for (auto i = 0; i < Children; ++i) {
+        const auto pos = Point{ (i % 4) * 60, (i / 4) * 26 };
+
+        if (kind == Kind::Label) {
+            auto label = std::make_unique<Label>("Value 123.4", &root);
+            label->setFont(Font{ Font::Family::Pxl16x8 });
+            label->setRect(Rect{ pos, Size{ 58, 16 } });
+            label->setAlignment(Align::Right);
+            children.push_back(std::move(label));
+        } else {
+            auto image = std::make_unique<Image>(Icon, 16, 16, &root);
+            image->setPos(pos);
+            children.push_back(std::move(image));
+        }
+
+        children.back()->setRetainedModeEnabled(retained);
+    }
+
+    Painter painter;
+    painter.paintWidget(&root);
+    painter.resetStatistics();
+
+    // Only the parent is invalidated, the children are repainted with it
+    const auto ns = Benchmark::measure(Iterations, [&](int) {
+        root.setBackgroundEnabled(true);
+        painter.paintWidget(&root);
+    });
+
+    replays = painter.statistics().replays;
+
+    children.clear();
+
+    return ns;
+}
+
+}
+
+int main()
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+
+    Benchmark::printHeader("Retained mode benchmark, parent repainted with 24 children");
+    std::printf(
+        "%-8s %14s %14s %14s %8s %10s\n",
+        "widget", "paint() ns", "replay ns", "saved/child ns", "speedup", "replays"
+    );
+
+    for (const auto kind : { Kind::Label, Kind::Image }) {
+        uint32_t replays = 0;
+
+        const auto paintNs = run(display, kind, false, replays);
+        const auto replayNs = run(display, kind, true, replays);
+
+        std::printf(
+            "%-8s %14.0f %14.0f %14.1f %7.1fx %10u\n",
+            kind == Kind::Label ? "Label" : "Image",
+            paintNs,
+            replayNs,
+            (paintNs - replayNs) / Children,
+            paintNs / replayNs,
+            replays
+        );
+    }
+
+    return 0;
+}
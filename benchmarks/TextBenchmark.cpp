@@ -0,0 +1,116 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+// Compares text drawn from the glyph atlas with u8g2_DrawStr(), which
+// Display::drawText() falls back to for fonts not in the atlas
+
+#include "Benchmark.h"
+#include "Display.h"
+#include "Font.h"
+#include "HeadlessBackend.h"
+
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+
+using namespace U8W;
+
+namespace
+{
+
+constexpr auto Iterations = 20000;
+
+struct Case
+{
+    const char* name;
+    Font font;
+    const char* text;
+};
+
+// Draws the text at changing positions, partly clipped when clipped is set
+double measure(Display& display, const Case& c, const bool clipped)
+{
+    display.setFont(c.font);
+
+    if (clipped) {
+        display.setClipRect(Rect{ 40, 40, 100, 40 });
+    } else {
+        display.resetClipRect();
+    }
+
+    return Benchmark::measure(Iterations, [&](const int i) {
+        display.drawText(Point{ (i * 7) % 120, 30 + (i * 3) % 100 }, c.text);
+    });
+}
+
+}
+
+int main()
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+    display.setGlyphAtlasBudget(16 * 1024);
+
+    const Case cases[] = {
+        { "PfTempesta7", Font{ Font::Family::PfTempesta7 }, "Temperature 23.5 C" },
+        { "Pxl16x8", Font{ Font::Family::Pxl16x8 }, "Temperature 23.5 C" },
+        { "Pxl16x8_x2", Font{ Font::Family::Pxl16x8_x2 }, "23.5 C" },
+        { "Pxl16x8_Mono", Font{ Font::Family::Pxl16x8_Mono }, "12:34:56" },
+        { "BitCellMono", Font{ Font::Family::BitCellMonoNumbers }, "0123456789" },
+    };
+
+    Benchmark::printHeader("Text benchmark, glyphs/s");
+    std::printf(
+        "%-14s %-8s %14s %14s %8s\n",
+        "font", "clip", "u8g2_DrawStr", "atlas", "speedup"
+    );
+
+    for (const auto& c : cases) {
+        const auto glyphs = static_cast<double>(std::strlen(c.text));
+
+        for (const auto clipped : { false, true }) {
+            display.setGlyphAtlasEnabled(c.font, false);
+            const auto u8g2Ns = measure(display, c, clipped);
+
+            display.setGlyphAtlasEnabled(c.font, true);
+            // The first pass decodes the glyphs into the atlas
+            measure(display, c, clipped);
+            const auto atlasNs = measure(display, c, clipped);
+
+            std::printf(
+                "%-14s %-8s %14.0f %14.0f %7.1fx\n",
+                c.name,
+                clipped ? "partial" : "none",
+                glyphs * 1e9 / u8g2Ns,
+                glyphs * 1e9 / atlasNs,
+                u8g2Ns / atlasNs
+            );
+        }
+
+        display.setGlyphAtlasEnabled(c.font, false);
+    }
+
+    const auto& statistics = display.glyphAtlasStatistics();
+    std::printf(
+        "\natlas: %u hits, %u misses, %u evictions, %u uncacheable\n",
+        statistics.hits,
+        statistics.misses,
+        statistics.evictions,
+        statistics.uncacheable
+    );
+
+    return 0;
+}
@@ -0,0 +1,211 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+// Compares the u8x8 byte traffic sent directly to a SPI sink with the
+// same traffic staged by CoalescingTransport. The sink charges a fixed
+// overhead per write call, like a blocking SPI write on the device. The
+// splits column counts the runs broken up by a full staging buffer.
+
+#include "Benchmark.h"
+#include "CoalescingTransport.h"
+#include "Display.h"
+#include "HeadlessBackend.h"
+#include "Transport.h"
+
+#include <array>
+#include <cstdio>
+#include <functional>
+
+using namespace U8W;
+
+namespace
+{
+
+constexpr auto Frames = 200;
+
+// Discards the data, accumulates the time the writes would take
+class SpiSink : public Transport
+{
+public:
+    static constexpr double CallOverheadNs = 2000.0;
+    static constexpr double ByteNs = 8 * 1e9 / 30'000'000;
+
+    void init(uint32_t, uint8_t) override {}
+    void setChipSelectLevel(bool) override {}
+    void setDataCommandLevel(bool) override {}
+
+    void write(const uint8_t* const data, const size_t length) override
+    {
+        Benchmark::doNotOptimize(data);
+        ++calls;
+        bytes += length;
+        busNs += CallOverheadNs + length * ByteNs;
+    }
+
+    void reset()
+    {
+        calls = 0;
+        bytes = 0;
+        busNs = 0;
+    }
+
+    uint32_t calls = 0;
+    uint32_t bytes = 0;
+    double busNs = 0;
+};
+
+std::array<uint8_t, 240> Data{};
+
+// A command/data driver sending each command byte and each tile on its
+// own, 20 tile rows of 30 tiles
+void sendTileRows(Transport& transport)
+{
+    const uint8_t commands[] = { 0x2a, 0x00, 0x00, 0x00, 0x4f, 0x2b, 0x00, 0x00 };
+
+    for (auto row = 0; row < 20; ++row) {
+        transport.setChipSelectLevel(false);
+        transport.setDataCommandLevel(false);
+
+        for (const auto& command : commands) {
+            transport.write(&command, 1);
+        }
+
+        transport.setDataCommandLevel(true);
+
+        for (auto tile = 0; tile < 30; ++tile) {
+            transport.write(Data.data() + tile * 8, 8);
+        }
+
+        transport.setChipSelectLevel(true);
+    }
+}
+
+// The ST7586S driver converts a tile row to 3 pixels per byte and sends
+// it as 8 lines of 80 bytes, a 640 byte run
+void sendConvertedRows(Transport& transport)
+{
+    for (auto row = 0; row < 20; ++row) {
+        transport.setChipSelectLevel(false);
+        transport.setDataCommandLevel(true);
+
+        for (auto line = 0; line < 8; ++line) {
+            transport.write(Data.data(), 80);
+        }
+
+        transport.setChipSelectLevel(true);
+    }
+}
+
+// One byte per call, as a bit-banged or per-pixel driver would do
+void sendSingleBytes(Transport& transport)
+{
+    transport.setChipSelectLevel(false);
+    transport.setDataCommandLevel(true);
+
+    for (auto i = 0; i < 4800; ++i) {
+        transport.write(Data.data() + i % Data.size(), 1);
+    }
+
+    transport.setChipSelectLevel(true);
+}
+
+void report(
+    const char* workload,
+    const char* path,
+    const double ns,
+    const SpiSink& sink,
+    const uint32_t splits = 0
+)
+{
+    std::printf(
+        "%-14s %-10s %10.0f %10u %10u %12.1f %8u\n",
+        workload,
+        path,
+        ns,
+        sink.calls / Frames,
+        sink.bytes / Frames,
+        sink.busNs / Frames / 1000,
+        splits / Frames
+    );
+}
+
+void run(
+    const char* workload,
+    const std::function<void(Transport&)>& send,
+    const size_t capacity = CoalescingTransport::DefaultCapacity
+)
+{
+    SpiSink sink;
+
+    auto ns = Benchmark::measure(Frames, [&](int) { send(sink); });
+    report(workload, "direct", ns, sink);
+
+    sink.reset();
+
+    CoalescingTransport coalescing{ sink, capacity };
+    ns = Benchmark::measure(Frames, [&](int) { send(coalescing); });
+    report(workload, "coalesced", ns, sink, coalescing.statistics().splits);
+}
+
+void runDisplay(
+    const char* path,
+    Transport& transport,
+    SpiSink& sink,
+    const CoalescingTransport* coalescing = nullptr
+)
+{
+    HeadlessBackend backend{ &transport };
+    Display display{ backend };
+
+    display.update();
+    sink.reset();
+
+    const auto ns = Benchmark::measure(Frames, [&](const int frame) {
+        display.fillRect(Rect{ (frame * 8) % 232, 40, 8, 80 });
+        display.update();
+    });
+
+    report("display", path, ns, sink, coalescing ? coalescing->statistics().splits : 0);
+}
+
+}
+
+int main()
+{
+    Benchmark::printHeader("Transport benchmark, per frame, 2 us per write call, 30 MHz SPI");
+    std::printf(
+        "%-14s %-10s %10s %10s %10s %12s %8s\n",
+        "workload", "path", "host ns", "calls", "bytes", "bus us", "splits"
+    );
+
+    run("tile rows", sendTileRows);
+    run("single bytes", sendSingleBytes);
+    run("st7586s 256", sendConvertedRows);
+    run("st7586s 640", sendConvertedRows, 640);
+
+    {
+        SpiSink sink;
+        runDisplay("direct", sink, sink);
+    }
+
+    {
+        SpiSink sink;
+        CoalescingTransport coalescing{ sink };
+        runDisplay("coalesced", coalescing, sink, &coalescing);
+    }
+
+    return 0;
+}
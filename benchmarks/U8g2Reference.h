@@ -0,0 +1,65 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "HeadlessBackend.h"
+
+#include <u8g2.h>
+#include <u8x8.h>
+
+#include <array>
+#include <cstdint>
+
+namespace U8W::Benchmark
+{
+
+// A bare u8g2 instance with the layout of the Display buffer, for
+// measuring the u8g2 drawing functions the fast paths replace
+class U8g2Reference
+{
+public:
+    U8g2Reference()
+    {
+        HeadlessBackend backend;
+        backend.setupDisplay(&_u8g2, u8x8_byte_empty);
+
+        u8g2_SetupBuffer(
+            &_u8g2,
+            _buffer.data(),
+            20,
+            u8g2_ll_hvline_horizontal_right_lsb,
+            U8G2_R0
+        );
+
+        u8g2_ClearBuffer(&_u8g2);
+    }
+
+    // u8g2 keeps pointers into the object
+    U8g2Reference(const U8g2Reference&) = delete;
+    U8g2Reference& operator=(const U8g2Reference&) = delete;
+
+    u8g2_t* get()
+    {
+        return &_u8g2;
+    }
+
+private:
+    u8g2_t _u8g2{};
+    std::array<uint8_t, 30 * 8 * 20> _buffer{};
+};
+
+}
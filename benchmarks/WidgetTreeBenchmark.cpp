@@ -0,0 +1,124 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+// Measures a paint pass over large widget trees when nothing changed
+// and when a single leaf changed
+
+#include "Arena.h"
+#include "Benchmark.h"
+#include "Display.h"
+#include "HeadlessBackend.h"
+#include "Label.h"
+#include "Painter.h"
+#include "Widget.h"
+
+#include <cstdio>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+
+using namespace U8W;
+
+namespace
+{
+
+constexpr auto Iterations = 20000;
+
+// Panels in a grid, each with a grid of small labels
+class Tree
+{
+public:
+    Tree(Display& display, const int panels, const int labelsPerPanel)
+        : root{ &display }
+        , _storage(static_cast<size_t>(panels) * (labelsPerPanel + 1) * (sizeof(Label) + 64))
+        , _arena{ _storage.data(), _storage.size() }
+    {
+        root.setRect(Rect{ Point{}, display.size() });
+
+        const auto panelColumns = 8;
+        const auto panelSize = Size{ 240 / panelColumns, 160 / ((panels + panelColumns - 1) / panelColumns) };
+
+        for (auto p = 0; p < panels; ++p) {
+            auto* const panel = _arena.create<Widget>(&root);
+            panel->setRect(Rect{
+                Point{ (p % panelColumns) * panelSize.width(), (p / panelColumns) * panelSize.height() },
+                panelSize
+            });
+
+            for (auto l = 0; l < labelsPerPanel; ++l) {
+                auto* const label = _arena.create<Label>(panel);
+                label->setRect(Rect{ (l % 5) * 6, (l / 5) * 4 % panelSize.height(), 6, 4 });
+                label->setNumber(l % 10);
+                labels.push_back(label);
+            }
+        }
+    }
+
+    Widget root;
+    std::vector<Label*> labels;
+
+private:
+    std::vector<uint8_t> _storage;
+    Arena _arena;
+};
+
+}
+
+int main()
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+
+    Benchmark::printHeader("Widget tree benchmark, ns per Painter::paintWidget");
+    std::printf(
+        "%-8s %-7s %12s %14s %8s\n",
+        "widgets", "mode", "idle poll", "single change", "paints"
+    );
+
+    for (const auto panels : { 10, 40, 160 }) {
+        for (const auto mode : { Painter::RepaintMode::Full, Painter::RepaintMode::Damage }) {
+            auto tree = std::make_unique<Tree>(display, panels, 25);
+
+            Painter painter;
+            painter.setRepaintMode(mode);
+            painter.paintWidget(&tree->root);
+
+            const auto idleNs = Benchmark::measure(Iterations, [&](int) {
+                painter.paintWidget(&tree->root);
+            });
+
+            painter.resetStatistics();
+
+            auto* const label = tree->labels[tree->labels.size() / 2];
+
+            const auto changeNs = Benchmark::measure(Iterations, [&](const int i) {
+                label->setNumber(i % 10);
+                painter.paintWidget(&tree->root);
+            });
+
+            std::printf(
+                "%-8zu %-7s %12.0f %14.0f %8.1f\n",
+                tree->labels.size() + panels + 1,
+                mode == Painter::RepaintMode::Full ? "full" : "damage",
+                idleNs,
+                changeNs,
+                static_cast<double>(painter.statistics().paints) / Iterations
+            );
+        }
+    }
+
+    return 0;
+}
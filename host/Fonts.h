@@ -0,0 +1,40 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <u8g2.h>
+
+#include <cstdint>
+
+// Stand-ins for the application's fonts in host builds, picked from the
+// fonts bundled with u8g2. The monospace families are mapped to
+// monospace fonts, so the monospace code paths are exercised.
+namespace Fonts
+{
+    constexpr const uint8_t* PfTempesta7 = u8g2_font_5x7_tr;
+    constexpr const uint8_t* PfTempesta7Bold = u8g2_font_5x8_tr;
+    constexpr const uint8_t* PfTempesta7Condensed = u8g2_font_4x6_tr;
+    constexpr const uint8_t* PfTempesta7CondensedBold = u8g2_font_5x7_tr;
+    constexpr const uint8_t* PfTempesta7CompressedBold = u8g2_font_4x6_tr;
+    constexpr const uint8_t* RpgSystem = u8g2_font_helvR08_tr;
+    constexpr const uint8_t* Pxl16x8 = u8g2_font_helvR10_tr;
+    constexpr const uint8_t* Pxl16x8_x2 = u8g2_font_helvR18_tr;
+    constexpr const uint8_t* Pxl16x8_Mono = u8g2_font_8x13_mr;
+    constexpr const uint8_t* Pxl16x8_Mono_x2 = u8g2_font_10x20_mr;
+    constexpr const uint8_t* BitCell = u8g2_font_helvB08_tr;
+    constexpr const uint8_t* BitCellMonoNumbers = u8g2_font_7x13_mr;
+}
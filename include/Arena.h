@@ -0,0 +1,111 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace U8W
+{
+
+// Bump allocator for building whole screens without using the heap.
+// Objects are destroyed in reverse order of creation, so children are
+// destroyed before their parents. Memory is only reclaimed by reset().
+class Arena
+{
+public:
+    Arena(uint8_t* buffer, size_t capacity);
+    ~Arena();
+
+    Arena(const Arena&) = delete;
+    Arena(Arena&&) = delete;
+    Arena& operator=(const Arena&) = delete;
+    Arena& operator=(Arena&&) = delete;
+
+    // Returns nullptr if the arena is full
+    template <typename T, typename... Args>
+    T* create(Args&&... args)
+    {
+        const auto used = _used;
+
+        Entry* entry = nullptr;
+
+        if constexpr (!std::is_trivially_destructible_v<T>) {
+            entry = static_cast<Entry*>(allocate(sizeof(Entry), alignof(Entry)));
+
+            if (!entry) {
+                return nullptr;
+            }
+        }
+
+        auto* const memory = allocate(sizeof(T), alignof(T));
+
+        if (!memory) {
+            _used = used;
+            return nullptr;
+        }
+
+        auto* const object = new (memory) T(std::forward<Args>(args)...);
+
+        if (entry) {
+            entry->object = object;
+            entry->destroy = [](void* p) { static_cast<T*>(p)->~T(); };
+            entry->previous = _last;
+            _last = entry;
+        }
+
+        return object;
+    }
+
+    // Destroys the objects and makes the whole buffer available again
+    void reset();
+
+    [[nodiscard]] size_t used() const;
+    [[nodiscard]] size_t capacity() const;
+
+private:
+    struct Entry
+    {
+        void* object;
+        void (*destroy)(void*);
+        Entry* previous;
+    };
+
+    uint8_t* const _buffer;
+    const size_t _capacity;
+    size_t _used = 0;
+    Entry* _last = nullptr;
+
+    [[nodiscard]] void* allocate(size_t size, size_t alignment);
+};
+
+template <size_t Capacity>
+class StaticArena : public Arena
+{
+public:
+    StaticArena()
+        : Arena{ _storage, Capacity }
+    {}
+
+private:
+    alignas(std::max_align_t) uint8_t _storage[Capacity];
+};
+
+}
@@ -0,0 +1,87 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "Rect.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace U8W
+{
+
+// Rendered widget pixels kept within a RAM budget, the least recently
+// used bitmaps are evicted first. The bitmaps are rows of MSB-first
+// bits, each row padded to whole bytes. They are identified by a key
+// which is unique to each widget for the lifetime of the program.
+class BitmapCache
+{
+public:
+    struct Statistics
+    {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint32_t evictions = 0;
+        // Current size of the cached bitmaps, kept on reset
+        uint32_t bytesHeld = 0;
+    };
+
+    // Zero disables the cache
+    void setBudget(size_t bytes);
+    [[nodiscard]] size_t budget() const;
+    [[nodiscard]] bool isEnabled() const;
+
+    // Returns the bitmap of the widget if it was stored with the same
+    // rectangle, nullptr otherwise
+    [[nodiscard]] const uint8_t* find(uint32_t key, const Rect& rect);
+
+    // Returns a buffer for the bitmap of the widget, nullptr if it
+    // doesn't fit into the budget
+    [[nodiscard]] uint8_t* insert(uint32_t key, const Rect& rect);
+
+    // Makes find() miss the bitmap until it is inserted again, the
+    // buffer is kept for the next insert()
+    void invalidate(uint32_t key);
+
+    void remove(uint32_t key);
+    void clear();
+
+    [[nodiscard]] const Statistics& statistics() const;
+    void resetStatistics();
+
+private:
+    struct Entry
+    {
+        uint32_t key = 0;
+        Rect rect;
+        uint32_t lastUse = 0;
+        bool valid = true;
+        std::vector<uint8_t> bits;
+    };
+
+    std::vector<Entry> _entries;
+    size_t _budget = 0;
+    uint32_t _useCounter = 0;
+    Statistics _statistics;
+
+    void evict(size_t index);
+    void removeAt(size_t index);
+    void shrinkTo(size_t bytes);
+};
+
+}
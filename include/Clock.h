@@ -0,0 +1,54 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <cstdint>
+
+namespace U8W
+{
+
+// Monotonic time source, injected so time dependent code can be driven
+// deterministically
+class Clock
+{
+public:
+    virtual ~Clock() = default;
+
+    [[nodiscard]] virtual uint64_t microseconds() const = 0;
+};
+
+// Host clock backed by std::chrono::steady_clock
+class SteadyClock : public Clock
+{
+public:
+    [[nodiscard]] uint64_t microseconds() const override;
+};
+
+// Only advances when told to
+class ManualClock : public Clock
+{
+public:
+    [[nodiscard]] uint64_t microseconds() const override;
+
+    void setMicroseconds(uint64_t us);
+    void advance(uint64_t us);
+
+private:
+    uint64_t _us = 0;
+};
+
+}
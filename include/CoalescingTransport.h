@@ -0,0 +1,67 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "Transport.h"
+
+#include <vector>
+
+namespace U8W
+{
+
+// Collects the small writes issued by the u8x8 driver and forwards
+// them as one write per chip select or data/command run. The capacity
+// should cover the longest run of the driver, longer runs are split.
+class CoalescingTransport : public Transport
+{
+public:
+    static constexpr size_t DefaultCapacity = 256;
+
+    struct Statistics
+    {
+        uint32_t writesReceived = 0;
+        uint32_t writesIssued = 0;
+        uint32_t bytes = 0;
+        // Writes which overflowed the staging buffer and split a run
+        uint32_t splits = 0;
+    };
+
+    explicit CoalescingTransport(Transport& transport, size_t capacity = DefaultCapacity);
+    ~CoalescingTransport() override;
+
+    void init(uint32_t clockHz, uint8_t spiMode) override;
+    void setChipSelectLevel(bool level) override;
+    void setDataCommandLevel(bool level) override;
+    void write(const uint8_t* data, size_t length) override;
+
+    void transmit(const TransferBuffer& buffer, CompletionHandler onComplete) override;
+    void waitForCompletion() override;
+    [[nodiscard]] bool isBusy() const override;
+
+    [[nodiscard]] const Statistics& statistics() const;
+    void resetStatistics();
+
+private:
+    Transport& _transport;
+    std::vector<uint8_t> _buffer;
+    size_t _length = 0;
+    Statistics _statistics;
+
+    void flush();
+};
+
+}
@@ -0,0 +1,54 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "Transport.h"
+
+namespace U8W
+{
+
+// Discards everything written to it, only counts the traffic
+class CountingTransport : public Transport
+{
+public:
+    struct Statistics
+    {
+        // Chip select activations, one per bus transaction
+        uint32_t transfers = 0;
+        uint32_t writes = 0;
+        uint32_t bytes = 0;
+    };
+
+    // chipSelectActiveLevel is the level that selects the device,
+    // low by default
+    explicit CountingTransport(bool chipSelectActiveLevel = false);
+
+    void init(uint32_t clockHz, uint8_t spiMode) override;
+    void setChipSelectLevel(bool level) override;
+    void setDataCommandLevel(bool level) override;
+    void write(const uint8_t* data, size_t length) override;
+
+    [[nodiscard]] const Statistics& statistics() const;
+    void resetStatistics();
+
+private:
+    const bool _chipSelectActiveLevel;
+    bool _chipSelectLevel;
+    Statistics _statistics;
+};
+
+}
@@ -15,20 +15,30 @@
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
 
 #include "Font.h"
+#include "Global.h"
+#include "GlyphAtlas.h"
 #include "Point.h"
 #include "Rect.h"
 #include "Size.h"
+#include "TextWidthCache.h"
 
+#include <functional>
 #include <memory>
 #include <string>
 
 namespace U8W
 {
 
+class DisplayBackend;
+class DisplayList;
+class LatencyTracer;
+
 class Display
 {
 public:
-    explicit Display();
+    using Color = U8W::Color;
+
+    explicit Display(DisplayBackend& backend);
     ~Display();
 
     Size size() const;
@@ -37,11 +47,78 @@ public:
     void clearBuffer();
 
     void update();
+    void setFullUpdateThreshold(int percent);
+    void setShadowBufferEnabled(bool enabled);
+
+    struct UpdateStatistics
+    {
+        uint32_t tilesCompared = 0;
+        uint32_t tilesSent = 0;
+        uint32_t bytesSaved = 0;
+    };
+
+    [[nodiscard]] const UpdateStatistics& updateStatistics() const;
+    void resetUpdateStatistics();
+
+    struct DrawStatistics
+    {
+        uint32_t drawCalls = 0;
+        uint32_t pixelsTouched = 0;
+    };
+
+    [[nodiscard]] const DrawStatistics& drawStatistics() const;
+    void resetDrawStatistics();
+
+    struct StateCacheStatistics
+    {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+    };
+
+    [[nodiscard]] const StateCacheStatistics& stateCacheStatistics() const;
+    void resetStateCacheStatistics();
+
+    [[nodiscard]] const TextWidthCache::Statistics& textWidthCacheStatistics() const;
+    void resetTextWidthCacheStatistics();
+
+    // Text in the enabled fonts is drawn from pre-decoded glyphs, the
+    // atlas is disabled until a budget is set
+    void setGlyphAtlasBudget(size_t bytes);
+    void setGlyphAtlasEnabled(const Font& font, bool enabled);
+    [[nodiscard]] const GlyphAtlas::Statistics& glyphAtlasStatistics() const;
+    void resetGlyphAtlasStatistics();
+
+    enum class UpdateMode
+    {
+        Synchronous,
+        Asynchronous
+    };
+
+    void setUpdateMode(UpdateMode mode);
+    void waitForUpdate();
+    [[nodiscard]] bool isUpdateInProgress() const;
+
+    // Called when a frame has been transmitted, in asynchronous mode it
+    // may run from a worker thread or only from the next update() or
+    // waitForUpdate(), depending on the transport
+    void setUpdateCompletedCallback(std::function<void()> callback);
+
+    // Only effective if the library is built with U8W_LATENCY_TRACING
+    void setLatencyTracer(LatencyTracer* tracer);
+    [[nodiscard]] LatencyTracer* latencyTracer() const;
 
     void setContrast(uint8_t value);
     void setBacklightLevel(uint8_t value);
     void setDrawColor(Color color);
     void setFont(const Font& font);
+
+    enum class FontMode
+    {
+        Solid,
+        Transparent
+    };
+
+    void setFontMode(FontMode mode);
     void setClipRect(const Rect& rect);
     void resetClipRect();
 
@@ -49,8 +126,10 @@ public:
     [[nodiscard]] int calculateFontDescent() const;
     [[nodiscard]] int calculateMaxCharHeight() const;
     [[nodiscard]] int calculateTextWidth(const std::string& text) const;
+    [[nodiscard]] int calculateTextWidth(const char* text) const;
 
     void drawText(const Point& pos, const std::string& s);
+    void drawText(const Point& pos, const char* s);
     void drawBitmap(const Point& pos, int width, int height, const uint8_t* data);
     void drawRect(const Rect& rect);
     void drawLine(const Point& from, const Point& to);
@@ -58,11 +137,28 @@ public:
 
     void fillRect(const Rect& rect);
 
+    // Copies the pixels of a rectangle inside the display into rows of
+    // MSB-first bits padded to whole bytes. Returns false if the frame
+    // buffer can't be accessed directly.
+    [[nodiscard]] bool readPixels(const Rect& rect, uint8_t* data) const;
+    // Writes back pixels read by readPixels(), clipped to the clip
+    // rectangle
+    void writePixels(const Rect& rect, const uint8_t* data);
+
+    // The state and drawing calls are appended to the list while they
+    // are executed, until endRecording(). Clipping is not recorded.
+    void beginRecording(DisplayList* list);
+    void endRecording();
+    void replay(const DisplayList& list);
+
 private:
     struct Private;
     std::unique_ptr<Private> _p;
 
     void setup();
+    // Returns false if nothing changed since the last update
+    bool sendChangedAreas();
+    void setFontData(const uint8_t* data);
 };
 
 }
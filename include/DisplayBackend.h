@@ -0,0 +1,48 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <u8g2.h>
+#include <u8x8.h>
+
+#include <cstdint>
+
+namespace U8W
+{
+
+class Transport;
+
+// Panel specific part of Display: the u8x8 driver, GPIO handling and
+// the transport used to reach the panel
+class DisplayBackend
+{
+public:
+    virtual ~DisplayBackend() = default;
+
+    // Sets up the u8x8 driver with the given byte callback, which
+    // forwards the traffic to transport()
+    virtual void setupDisplay(u8g2_t* u8g2, u8x8_msg_cb byteCallback) = 0;
+
+    // Called after the buffer is set up, before the display is initialized
+    virtual void init() {}
+
+    virtual Transport& transport() = 0;
+
+    virtual void setBacklightLevel(uint8_t /*value*/) {}
+};
+
+}
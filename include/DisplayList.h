@@ -0,0 +1,76 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace U8W
+{
+
+// Recorded sequence of Display drawing calls. Each command is an opcode
+// byte followed by its operands, all of them packed into one flat
+// buffer which keeps its capacity when the list is re-recorded.
+class DisplayList
+{
+public:
+    enum class Opcode : uint8_t
+    {
+        SetDrawColor,
+        SetFont,
+        SetFontMode,
+        DrawText,
+        DrawBitmap,
+        DrawRect,
+        DrawLine,
+        FillRect
+    };
+
+    void clear();
+
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] size_t sizeInBytes() const;
+
+    void addOpcode(Opcode opcode);
+    void addInt(int value);
+    void addPointer(const void* pointer);
+    void addText(const char* text);
+
+    class Reader
+    {
+    public:
+        explicit Reader(const DisplayList& list);
+
+        [[nodiscard]] bool atEnd() const;
+
+        [[nodiscard]] Opcode readOpcode();
+        [[nodiscard]] int readInt();
+        [[nodiscard]] const void* readPointer();
+        // Zero-terminated
+        [[nodiscard]] const char* readText();
+
+    private:
+        const uint8_t* _pos;
+        const uint8_t* const _end;
+    };
+
+private:
+    std::vector<uint8_t> _data;
+};
+
+}
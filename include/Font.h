@@ -16,6 +16,8 @@
 
 #pragma once
 
+#include "FontMetrics.h"
+
 #include <cstdint>
 
 namespace U8W
@@ -43,7 +45,7 @@ public:
         Compressed
     };
 
-    Font() = default;
+    Font();
 
     explicit Font(
         Family family,
@@ -56,10 +58,16 @@ public:
 
     const uint8_t* data() const;
 
+    [[nodiscard]] bool isMonospace() const;
+    [[nodiscard]] const FontMetrics& metrics() const;
+
 private:
     Family _family = Family::PfTempesta7;
     Style _style = Style::Condensed;
     bool _bold = false;
+    FontMetrics _metrics;
+
+    void updateMetrics();
 };
 
 }
@@ -0,0 +1,181 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace U8W
+{
+
+// Metrics read directly from the header of a u8g2 font, matching what
+// u8g2 reports in the default (text) font height mode. The u8g2 fonts
+// are extern arrays, Font reads their metrics at runtime once per font
+// change instead of calling into u8g2 on every measurement.
+struct FontMetrics
+{
+    int ascent = 0;
+    int descent = 0;
+    int maxCharWidth = 0;
+    int maxCharHeight = 0;
+    // Left edge of the font bounding box relative to the glyph origin
+    int xOffset = 0;
+
+    // Advance of the '0' glyph for monospace fonts, 0 otherwise
+    int fixedAdvance = 0;
+
+    [[nodiscard]] constexpr bool isMonospace() const noexcept
+    {
+        return fixedAdvance > 0;
+    }
+
+    // Width of a monospace text in whole character cells. Unlike
+    // u8g2_GetStrWidth() it does not depend on the last glyph, so
+    // aligned numbers keep their position when digits change.
+    [[nodiscard]] constexpr int monospaceTextWidth(const size_t length) const noexcept
+    {
+        return fixedAdvance * static_cast<int>(length);
+    }
+
+    // Pixels a glyph may draw left and right of its monospace cell, the
+    // font bounding box is wider than the advance for some fonts
+    [[nodiscard]] constexpr int leftOverhang() const noexcept
+    {
+        return xOffset < 0 ? -xOffset : 0;
+    }
+
+    [[nodiscard]] constexpr int rightOverhang() const noexcept
+    {
+        const auto overhang = xOffset + maxCharWidth - fixedAdvance;
+        return overhang > 0 ? overhang : 0;
+    }
+
+    // Horizontal extent, with an exclusive right side
+    struct Span
+    {
+        int left = 0;
+        int right = 0;
+    };
+
+    // Pixels the glyphs of the cells [first, last) of a monospace text
+    // drawn at x may touch, including the overhangs
+    [[nodiscard]] constexpr Span monospaceCellSpan(const int x, const size_t first, const size_t last) const noexcept
+    {
+        return Span{
+            x + monospaceTextWidth(first) - leftOverhang(),
+            x + monospaceTextWidth(last) + rightOverhang()
+        };
+    }
+
+    [[nodiscard]] static constexpr FontMetrics fromData(const uint8_t* const font, const bool monospace)
+    {
+        FontMetrics m;
+
+        if (!font) {
+            return m;
+        }
+
+        m.maxCharWidth = font[9];
+        m.maxCharHeight = font[10];
+        m.xOffset = static_cast<int8_t>(font[11]);
+        m.ascent = static_cast<int8_t>(font[13]);
+        m.descent = static_cast<int8_t>(font[14]);
+
+        if (monospace) {
+            m.fixedAdvance = glyphAdvance(font, '0');
+        }
+
+        return m;
+    }
+
+    [[nodiscard]] static constexpr int glyphAdvance(const uint8_t* const font, const uint8_t encoding)
+    {
+        const auto* const glyph = findGlyph(font, encoding);
+
+        if (!glyph) {
+            return 0;
+        }
+
+        // The glyph header follows the encoding and the offset of the
+        // next glyph, as bit fields in the order u8g2 decodes them
+        BitReader reader{ glyph + 2 };
+        reader.readUnsigned(font[4]);       // width
+        reader.readUnsigned(font[5]);       // height
+        reader.readSigned(font[6]);         // x offset
+        reader.readSigned(font[7]);         // y offset
+        return reader.readSigned(font[8]);  // delta x
+    }
+
+    static constexpr size_t HeaderSize = 23;
+
+    // Reads the bit fields of the glyph data the way u8g2 does
+    struct BitReader
+    {
+        const uint8_t* data;
+        unsigned bitPos = 0;
+
+        constexpr unsigned readUnsigned(const unsigned count)
+        {
+            unsigned value = data[0] >> bitPos;
+            auto end = bitPos + count;
+
+            if (end >= 8) {
+                value |= static_cast<unsigned>(data[1]) << (8 - bitPos);
+                ++data;
+                end -= 8;
+            }
+
+            bitPos = end;
+
+            return value & ((1u << count) - 1);
+        }
+
+        constexpr int readSigned(const unsigned count)
+        {
+            // An empty field has no sign bit to shift
+            if (count == 0) {
+                return 0;
+            }
+
+            return static_cast<int>(readUnsigned(count)) - (1 << (count - 1));
+        }
+    };
+
+    // Returns the glyph entry (encoding, offset to the next glyph, data)
+    [[nodiscard]] static constexpr const uint8_t* findGlyph(const uint8_t* const font, const uint8_t encoding)
+    {
+        const auto* glyph = font + HeaderSize;
+
+        if (encoding >= 'a') {
+            glyph += (font[19] << 8) | font[20];
+        } else if (encoding >= 'A') {
+            glyph += (font[17] << 8) | font[18];
+        }
+
+        while (glyph[1] != 0) {
+            if (glyph[0] == encoding) {
+                return glyph;
+            }
+
+            glyph += glyph[1];
+        }
+
+        return nullptr;
+    }
+};
+
+}
@@ -0,0 +1,92 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "Rect.h"
+
+#include <cstdint>
+
+namespace U8W
+{
+
+// Direct access to a 1bpp framebuffer in the u8g2 horizontal layout
+// (u8g2_ll_hvline_horizontal_right_lsb): rows of bytes, the leftmost
+// pixel of each byte is its most significant bit.
+class FrameBuffer
+{
+public:
+    FrameBuffer() = default;
+    FrameBuffer(uint8_t* data, int width, int height, int stride);
+
+    [[nodiscard]] bool isNull() const;
+    [[nodiscard]] Rect rect() const;
+
+    // Draws a row of pixels given as MSB-first bits, clipped to the clip
+    // rectangle. Set bits are drawn with the color (u8g2 draw color:
+    // 0, 1 or 2 for XOR), cleared bits are drawn with the background
+    // color in solid mode and left untouched otherwise.
+    void drawBits(
+        int x,
+        int y,
+        const uint8_t* bits,
+        int width,
+        int color,
+        bool solid,
+        const Rect& clip
+    );
+
+    // Draws an XBM bitmap (rows padded to bytes, leftmost pixel in the
+    // LSB) like u8g2_DrawXBM() does
+    void drawXbm(
+        int x,
+        int y,
+        int width,
+        int height,
+        const uint8_t* data,
+        int color,
+        bool solid,
+        const Rect& clip
+    );
+
+    // Fills a rectangle like u8g2_DrawBox() does. Whole bytes inside
+    // each row are written a word at a time, only the edges are masked.
+    void fillRect(const Rect& rect, int color, const Rect& clip);
+
+    // Copies the pixels of a rectangle inside the buffer into rows of
+    // MSB-first bits, each row padded to whole bytes. drawBits() with
+    // color 1 in solid mode writes them back.
+    void copyRect(const Rect& rect, uint8_t* data) const;
+
+private:
+    uint8_t* _data = nullptr;
+    int _width = 0;
+    int _height = 0;
+    int _stride = 0;
+
+    template <bool LsbFirst>
+    void drawRow(
+        int x,
+        int y,
+        const uint8_t* bits,
+        int width,
+        int color,
+        bool solid,
+        const Rect& area
+    );
+};
+
+}
@@ -0,0 +1,82 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "TimingWindow.h"
+
+#include <cstdint>
+
+namespace U8W
+{
+
+class Clock;
+class Display;
+class Painter;
+class Widget;
+
+// Renders the widget tree at most at the configured frame rate. All the
+// changes made between two frames are painted and sent to the display
+// in one go.
+class FrameScheduler
+{
+public:
+    FrameScheduler(Widget* root, Painter& painter, Display& display, Clock& clock);
+
+    // Zero removes the limit
+    void setMaxFrameRate(int framesPerSecond);
+
+    // Forces a display update in the next frame, for changes which are
+    // not tracked by the widgets
+    void invalidate();
+
+    // Renders a frame if anything changed and the frame interval has
+    // elapsed, returns true if a frame was rendered
+    bool poll();
+
+    // Microseconds until poll() may render the next frame
+    [[nodiscard]] uint32_t timeUntilNextFrame() const;
+
+    struct Statistics
+    {
+        uint32_t frames = 0;
+        // Polls with pending changes postponed by the frame rate limit
+        uint32_t deferredPolls = 0;
+        // Frame slots missed because a frame took longer than the
+        // frame interval
+        uint32_t droppedFrames = 0;
+        TimingWindow paintTime;
+        TimingWindow transferTime;
+    };
+
+    [[nodiscard]] const Statistics& statistics() const;
+    void resetStatistics();
+
+private:
+    Widget* const _root;
+    Painter& _painter;
+    Display& _display;
+    Clock& _clock;
+
+    uint32_t _frameInterval = 0;
+    uint64_t _lastFrameStart = 0;
+    bool _hasRenderedFrame = false;
+    bool _invalidated = true;
+
+    Statistics _statistics;
+};
+
+}
@@ -0,0 +1,91 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace U8W
+{
+
+// Cache of decoded glyphs as packed 1bpp bitmaps, so text can be drawn
+// with row blits instead of running the u8g2 RLE decoder every time.
+// It is organized as a 4-way set associative cache with LRU eviction
+// within each set, its size is given as a RAM budget.
+class GlyphAtlas
+{
+public:
+    static constexpr size_t MaxGlyphBytes = 64;
+    static constexpr size_t Ways = 4;
+
+    struct Glyph
+    {
+        // Top-left corner relative to the baseline origin
+        int8_t x = 0;
+        int8_t y = 0;
+        uint8_t width = 0;
+        uint8_t height = 0;
+        int8_t advance = 0;
+
+        // Rows of stride() bytes, leftmost pixel in the MSB
+        uint8_t bits[MaxGlyphBytes];
+
+        [[nodiscard]] int stride() const
+        {
+            return (width + 7) / 8;
+        }
+    };
+
+    struct Statistics
+    {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+        uint32_t evictions = 0;
+        uint32_t uncacheable = 0;
+    };
+
+    void setBudget(size_t bytes);
+    [[nodiscard]] size_t budget() const;
+    [[nodiscard]] bool isEnabled() const;
+
+    void clear();
+
+    // Returns nullptr if the glyph is too large for the atlas
+    [[nodiscard]] const Glyph* find(const uint8_t* font, uint8_t encoding);
+
+    [[nodiscard]] const Statistics& statistics() const;
+    void resetStatistics();
+
+private:
+    struct Slot
+    {
+        const uint8_t* font = nullptr;
+        uint8_t encoding = 0;
+        uint32_t lastUse = 0;
+        Glyph glyph;
+    };
+
+    std::vector<Slot> _slots;
+    size_t _sets = 0;
+    uint32_t _useCounter = 0;
+    Statistics _statistics;
+
+    static bool decode(const uint8_t* font, uint8_t encoding, Glyph& glyph);
+};
+
+}
@@ -0,0 +1,45 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "CountingTransport.h"
+#include "DisplayBackend.h"
+
+namespace U8W
+{
+
+// In-memory 240x160 display without any hardware dependency, for
+// running and measuring the widget code on the host. The frame is
+// rendered into the u8g2 buffer, transfers go to the given transport
+// or to a CountingTransport by default.
+class HeadlessBackend : public DisplayBackend
+{
+public:
+    explicit HeadlessBackend(Transport* transport = nullptr);
+
+    void setupDisplay(u8g2_t* u8g2, u8x8_msg_cb byteCallback) override;
+
+    Transport& transport() override;
+
+    [[nodiscard]] const CountingTransport::Statistics& transportStatistics() const;
+
+private:
+    CountingTransport _countingTransport;
+    Transport* const _transport;
+};
+
+}
@@ -17,9 +17,17 @@
 #pragma once
 
 #include "Font.h"
+#include "Global.h"
+#include "NumberFormat.h"
 #include "Widget.h"
 
-#include <string>
+#include <cstddef>
+#include <string_view>
+
+// Capacity of the inline text buffer of labels
+#ifndef U8W_LABEL_MAX_TEXT_LENGTH
+#define U8W_LABEL_MAX_TEXT_LENGTH 31
+#endif
 
 namespace U8W
 {
@@ -27,14 +35,29 @@ namespace U8W
 class Label : public Widget
 {
 public:
+    static constexpr size_t MaxTextLength = U8W_LABEL_MAX_TEXT_LENGTH;
+
     explicit Label(Widget* parent);
-    Label(std::string text, Widget* parent);
+    Label(std::string_view text, Widget* parent);
 
     virtual void paint() override;
 
-    void setText(std::string text);
+    // Longer text than MaxTextLength is truncated. Setting the current
+    // text again does nothing.
+    void setText(std::string_view text);
+
+    [[nodiscard]] std::string_view text() const;
+
+    // Formatted in place, see formatNumber() and formatFixedPoint()
+    void setNumber(int32_t value, const NumberFormat& format = {});
+    void setFixedPoint(int32_t value, uint8_t decimals, const NumberFormat& format = {});
+
     void setFont(const Font& font);
 
+    // With a monospace font, a text of the same length only repaints the
+    // glyph cells that changed
+    void setIncrementalRedrawEnabled(bool enabled);
+
     void setAlignment(Align alignment);
 
     enum class HeightCalculation
@@ -46,14 +69,21 @@ public:
     void setHeightCalculation(HeightCalculation heightCalculation);
 
 private:
-    std::string _text;
+    char _text[MaxTextLength + 1] = {};
+    size_t _textLength = 0;
     Font _font;
     Align _alignment = Align::Left;
+    // Relative to the top left corner of the label
     Point _textPos;
     HeightCalculation _heightCalculation = HeightCalculation::WithDescent;
+    bool _incrementalRedraw = false;
 
+    // Returns false if the text is unchanged
+    bool storeText(std::string_view text);
+    bool updateChangedGlyphCells(std::string_view text);
     void updateHeightByFont();
     void updateTextPosition();
+    [[nodiscard]] int calculateTextWidth() const;
 };
 
 }
@@ -0,0 +1,110 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "TimingWindow.h"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Compiles the latency tracing hooks into Widget, Painter and Display
+#ifndef U8W_LATENCY_TRACING
+#define U8W_LATENCY_TRACING 0
+#endif
+
+namespace U8W
+{
+
+class Clock;
+
+// Measures the time from the first invalidation of a widget until the
+// end of the transfer which carried its repainted pixels. Widgets are
+// told apart by their names.
+//
+// In asynchronous update mode frameTransferred() runs from the transfer
+// completion context. Transports which defer the completion handler to
+// waitForCompletion() include that delay in the measured latency. It never overlaps frameSubmitted(): Display waits
+// for the frame in flight before submitting the next one, and the
+// transports return from waitForCompletion() only after the completion
+// handler returned. The results should only be read while no update is
+// in progress.
+class LatencyTracer
+{
+public:
+    static constexpr size_t MaxWidgets = 16;
+    static constexpr size_t MaxPaintsPerFrame = 32;
+    static constexpr size_t MaxNameLength = 15;
+
+    struct WidgetLatency
+    {
+        char name[MaxNameLength + 1] = {};
+        TimingWindow latency;
+    };
+
+    explicit LatencyTracer(Clock& clock);
+
+    [[nodiscard]] uint64_t now() const;
+
+    void widgetPainted(const char* name, uint64_t invalidatedAt);
+
+    // The painted widgets are carried by the frame which is being sent.
+    // Paints of a previous frame which was never reported transferred
+    // are counted as dropped samples.
+    void frameSubmitted();
+    void frameTransferred();
+
+    // Drops the painted widgets if they didn't change the panel content,
+    // doesn't touch the frame in flight
+    void frameSkipped();
+
+    [[nodiscard]] size_t widgetCount() const;
+    [[nodiscard]] const WidgetLatency& widget(size_t index) const;
+
+    // Latency of the oldest invalidation carried by each frame
+    [[nodiscard]] const TimingWindow& frameLatency() const;
+
+    // Paints which didn't fit into the frame or the widget table
+    [[nodiscard]] uint32_t droppedSamples() const;
+
+    void reset();
+
+private:
+    struct Paint
+    {
+        uint8_t widget = 0;
+        uint64_t invalidatedAt = 0;
+    };
+
+    struct Frame
+    {
+        std::array<Paint, MaxPaintsPerFrame> paints;
+        size_t count = 0;
+    };
+
+    Clock& _clock;
+    std::array<WidgetLatency, MaxWidgets> _widgets;
+    size_t _widgetCount = 0;
+    Frame _pending;
+    Frame _inFlight;
+    TimingWindow _frameLatency;
+    uint32_t _droppedSamples = 0;
+
+    [[nodiscard]] int findOrAddWidget(const char* name);
+};
+
+}
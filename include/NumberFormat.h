@@ -0,0 +1,57 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace U8W
+{
+
+struct NumberFormat
+{
+    // Minimum length of the number without the suffix
+    uint8_t width = 0;
+    // Fills up to the width, zeros are put after the sign
+    char padding = ' ';
+    // Unit appended after the number, e.g. "%" or " V"
+    const char* suffix = nullptr;
+};
+
+// Longest unpadded number formatNumber() writes: a sign and 10 digits
+constexpr size_t MaxNumberLength = 11;
+
+// Formats the number into the buffer without allocating and returns the
+// length. The output is truncated to fit and always terminated.
+size_t formatNumber(
+    char* buffer,
+    size_t capacity,
+    int32_t value,
+    const NumberFormat& format = {}
+);
+
+// The value is scaled by 10^decimals, e.g. 1234 with 2 decimals is
+// formatted as 12.34. At most 9 decimals are supported.
+size_t formatFixedPoint(
+    char* buffer,
+    size_t capacity,
+    int32_t value,
+    uint8_t decimals,
+    const NumberFormat& format = {}
+);
+
+}
@@ -16,6 +16,13 @@
 
 #pragma once
 
+#include "BitmapCache.h"
+#include "Region.h"
+#include "RenderProfiler.h"
+
+#include <cstdint>
+#include <vector>
+
 namespace U8W
 {
 
@@ -26,11 +33,95 @@ class Painter
 public:
     explicit Painter();
 
+    enum class RepaintMode
+    {
+        // Dirty widgets are repainted with their whole subtree. The
+        // painter's lists keep their capacity, so once they have grown
+        // to the tree, frames don't allocate.
+        Full,
+        // Only the damaged areas are repainted, clipped to the damage.
+        // The damage regions are built on the heap in every frame.
+        Damage
+    };
+
+    void setRepaintMode(RepaintMode mode);
+
+    // Dirty widgets completely covered by opaque widgets painted after
+    // them are skipped
+    void setOcclusionCullingEnabled(bool enabled);
+
+    struct Statistics
+    {
+        uint32_t paints = 0;
+        uint32_t culledPaints = 0;
+        // Paints served from a retained display list
+        uint32_t replays = 0;
+    };
+
+    [[nodiscard]] const Statistics& statistics() const;
+    void resetStatistics();
+
+    // Budget of the widget bitmaps, see Widget::setCacheMode(). The
+    // cache is disabled until a budget is set.
+    void setBitmapCacheBudget(size_t bytes);
+    [[nodiscard]] const BitmapCache::Statistics& bitmapCacheStatistics() const;
+    void resetBitmapCacheStatistics();
+
+    // Records every widget paint, only effective if the library is
+    // built with U8W_RENDER_PROFILING
+    void setRenderProfiler(RenderProfiler* profiler);
+
     void paintWidget(Widget* widget);
 
+    // Paints the dirty widgets without updating the display, returns
+    // true if anything was painted
+    bool renderWidget(Widget* widget);
+
 private:
-    static void updateWidgetRepaintFlags(Widget* w);
-    static bool paintWidgetRecursive(Widget* w);
+    RepaintMode _repaintMode = RepaintMode::Full;
+    bool _damageRectsOutdated = false;
+    bool _occlusionCullingEnabled = false;
+    Statistics _statistics;
+
+    // Widgets to repaint in the current pass, in painting order
+    std::vector<Widget*> _repaintList;
+
+    BitmapCache _bitmapCache;
+    // Widgets to capture when their subtree is painted, innermost last
+    std::vector<Widget*> _pendingCaptures;
+
+    RenderProfiler* _profiler = nullptr;
+#if U8W_RENDER_PROFILING
+    // Parallel to _repaintList
+    std::vector<RenderProfiler::Reason> _repaintReasons;
+#endif
+
+    // Clip rectangle of the widget limited to the display area
+    [[nodiscard]] static Rect visibleRect(const Widget* w);
+    // The part of the clip rectangle to repaint for the widget itself
+    [[nodiscard]] static Rect repaintRect(const Widget* w, const Rect& clipRect);
+    // Drops the repaint request of a painted (or skipped) widget, so no
+    // stale partial area survives into its next request
+    static void clearRepaintRequest(Widget* w);
+
+    bool paintFull(Widget* root);
+    bool paintDamage(Widget* root);
+    void paintContent(Widget* w);
+    void paintWidgetBackgroundAndContent(Widget* w, const Rect& clipRect, RenderProfiler::Reason reason);
+
+    [[nodiscard]] bool isCacheable(const Widget* w) const;
+    [[nodiscard]] static bool isAncestor(const Widget* ancestor, const Widget* w);
+    size_t skipDescendants(size_t index);
+    [[nodiscard]] const uint8_t* findCachedBitmap(const Widget* w, const Rect& clipRect);
+    void drawCachedBitmap(Widget* w, const Rect& rect, const Rect& bitmapRect, const uint8_t* bits);
+    void captureBitmap(Widget* w, const Rect& clipRect);
+
+    void scheduleRepaints(Widget* w, bool parentRepainted);
+    void collectDamage(Widget* w, Region& damage, bool geometryChanged);
+    void paintDamageRecursive(Widget* w, const Region& damage);
+
+    void cullOccludedWidgets(Widget* root);
+    bool cullOccludedWidgetsRecursive(Widget* w, const Rect& bounds, Region& cover, size_t& remaining);
 };
 
 }
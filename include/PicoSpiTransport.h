@@ -0,0 +1,67 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "Transport.h"
+
+namespace U8W
+{
+
+// SPI0 transport for the RP2040. Asynchronous transfers are fed to the
+// SPI TX FIFO by DMA while a second channel drains the RX FIFO. The RX
+// channel finishes when the last byte is clocked out, its interrupt then
+// switches chip select and data/command and starts the next segment, so
+// the interrupt never waits for the bus.
+//
+// The DMA_IRQ_0 handler is registered as a shared handler, other code may
+// add its own for other channels. The interrupt only flags the end of the
+// transfer, the completion handler is run by waitForCompletion() from the
+// caller's context (the next update() or Display::waitForUpdate()).
+class PicoSpiTransport : public Transport
+{
+public:
+    PicoSpiTransport(unsigned csPin, unsigned dcPin);
+    ~PicoSpiTransport() override;
+
+    void init(uint32_t clockHz, uint8_t spiMode) override;
+    void setChipSelectLevel(bool level) override;
+    void setDataCommandLevel(bool level) override;
+    void write(const uint8_t* data, size_t length) override;
+
+    void transmit(const TransferBuffer& buffer, CompletionHandler onComplete) override;
+    void waitForCompletion() override;
+    [[nodiscard]] bool isBusy() const override;
+
+private:
+    const unsigned _csPin;
+    const unsigned _dcPin;
+    int _txChannel = -1;
+    int _rxChannel = -1;
+    uint8_t _rxSink = 0;
+
+    const TransferBuffer* _buffer = nullptr;
+    size_t _offset = 0;
+    CompletionHandler _onComplete;
+    volatile bool _busy = false;
+    volatile bool _transferDone = false;
+
+    void processSegments();
+
+    static void dmaInterruptHandler();
+};
+
+}
@@ -67,7 +67,7 @@ public:
 
     [[nodiscard]] constexpr inline int manhattanLength() const
     {
-        return Utils::abs(x()) + Utils::abs(y());
+        return U8W::Utils::abs(x()) + U8W::Utils::abs(y());
     }
 
     constexpr inline Point& operator+=(const Point& p) noexcept
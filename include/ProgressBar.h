@@ -16,12 +16,14 @@
 
 #pragma once
 
+#include "NumberFormat.h"
 #include "Rect.h"
 
 #include <u8g2.h>
 #include <u8x8.h>
 
-#include <string>
+#include <cstddef>
+#include <string_view>
 
 namespace U8W
 {
@@ -29,11 +31,17 @@ namespace U8W
 class ProgressBar
 {
 public:
+    static constexpr size_t MaxTextLength = 15;
+
     explicit ProgressBar(u8g2_t& display);
 
     void setRect(int x, int y, int w, int h);
     void setPosition(int pos);
-    void setText(std::string text);
+    // An empty text shows the position in percent. Longer text than
+    // MaxTextLength is truncated.
+    void setText(std::string_view text);
+    void setNumber(int32_t value, const NumberFormat& format = {});
+    void setFixedPoint(int32_t value, uint8_t decimals, const NumberFormat& format = {});
 
     void update();
 
@@ -41,7 +49,7 @@ private:
     u8g2_t& _display;
     Rect _rect;
     int _position = 0;
-    std::string _text;
+    char _text[MaxTextLength + 1] = {};
     bool _useDefaultText = true;
 };
 
@@ -0,0 +1,83 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "Rect.h"
+
+#include <vector>
+
+namespace U8W
+{
+
+// Set of pixels stored as non-overlapping rectangles sorted in y-x
+// bands: rectangles of a band share their top and bottom, and vertically
+// adjacent bands with the same horizontal spans are merged.
+class Region
+{
+public:
+    Region() = default;
+    Region(const Rect& rect);
+
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] Rect boundingRect() const;
+    [[nodiscard]] bool intersects(const Rect& rect) const;
+
+    [[nodiscard]] inline const std::vector<Rect>& rects() const
+    {
+        return _rects;
+    }
+
+    void clear();
+
+    [[nodiscard]] Region operator|(const Region& r) const;
+    [[nodiscard]] Region operator&(const Region& r) const;
+    [[nodiscard]] Region operator-(const Region& r) const;
+
+    Region& operator|=(const Region& r);
+    Region& operator&=(const Region& r);
+    Region& operator-=(const Region& r);
+
+    [[nodiscard]] inline Region united(const Region& r) const
+    {
+        return *this | r;
+    }
+
+    [[nodiscard]] inline Region intersected(const Region& r) const
+    {
+        return *this & r;
+    }
+
+    [[nodiscard]] inline Region subtracted(const Region& r) const
+    {
+        return *this - r;
+    }
+
+private:
+    enum class Operation
+    {
+        Union,
+        Intersection,
+        Subtraction
+    };
+
+    std::vector<Rect> _rects;
+    Rect _boundingRect;
+
+    static Region combine(const Region& a, const Region& b, Operation op);
+};
+
+}
@@ -0,0 +1,98 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Compiles the profiling hooks into Painter
+#ifndef U8W_RENDER_PROFILING
+#define U8W_RENDER_PROFILING 0
+#endif
+
+namespace U8W
+{
+
+class Clock;
+
+// Fixed size ring buffer of per-widget paint records. Recording doesn't
+// allocate or print, the records can be inspected or dumped after the
+// fact.
+class RenderProfiler
+{
+public:
+    static constexpr size_t Capacity = 256;
+    static constexpr size_t MaxNameLength = 15;
+
+    enum class Reason : uint8_t
+    {
+        // The widget itself changed
+        Self,
+        // Its parent was repainted
+        Parent,
+        // A child changed its geometry
+        Child,
+        // It intersected the damage (damage repaint mode)
+        Damage
+    };
+
+    struct Record
+    {
+        uint32_t frame = 0;
+        uint32_t paintTime = 0;
+        uint32_t pixelsCleared = 0;
+        uint16_t drawCalls = 0;
+        Reason reason = Reason::Self;
+        char name[MaxNameLength + 1] = {};
+    };
+
+    explicit RenderProfiler(Clock& clock);
+
+    [[nodiscard]] Clock& clock() const;
+
+    // Records after this belong to a new frame, if the previous one has
+    // any
+    void beginFrame();
+
+    void record(
+        const char* name,
+        Reason reason,
+        uint32_t paintTime,
+        uint32_t pixelsCleared,
+        uint32_t drawCalls
+    );
+
+    // Records from the oldest to the newest
+    [[nodiscard]] size_t size() const;
+    [[nodiscard]] const Record& at(size_t index) const;
+
+    void clear();
+
+    void dump(std::ostream& os) const;
+
+private:
+    Clock& _clock;
+    std::array<Record, Capacity> _records;
+    size_t _next = 0;
+    size_t _size = 0;
+    uint32_t _frame = 0;
+    bool _frameHasRecords = false;
+};
+
+}
@@ -0,0 +1,48 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "CoalescingTransport.h"
+#include "DisplayBackend.h"
+#include "PicoSpiTransport.h"
+
+namespace U8W
+{
+
+// ERC240160 panel with an ST7586S controller on the RP2040 SPI0 bus
+class St7586sBackend : public DisplayBackend
+{
+public:
+    explicit St7586sBackend();
+
+    void setupDisplay(u8g2_t* u8g2, u8x8_msg_cb byteCallback) override;
+    void init() override;
+
+    Transport& transport() override;
+
+    void setBacklightLevel(uint8_t value) override;
+
+private:
+    // One tile row after the conversion to 3 pixels per byte: 8 lines
+    // of 80 bytes
+    static constexpr size_t MaxRunLength = 8 * 240 / 3;
+
+    PicoSpiTransport _spiTransport;
+    CoalescingTransport _transport;
+};
+
+}
@@ -0,0 +1,67 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace U8W
+{
+
+// Fixed size LRU cache of text widths keyed by font data and string.
+// Longer strings than MaxTextLength are not cached.
+class TextWidthCache
+{
+public:
+    static constexpr size_t Capacity = 32;
+    static constexpr size_t MaxTextLength = 23;
+
+    struct Statistics
+    {
+        uint32_t hits = 0;
+        uint32_t misses = 0;
+    };
+
+    // Returns the width or -1 if the text is not in the cache
+    [[nodiscard]] int find(const uint8_t* font, const char* text, size_t length);
+    void insert(const uint8_t* font, const char* text, size_t length, int width);
+
+    void clear();
+
+    [[nodiscard]] const Statistics& statistics() const;
+    void resetStatistics();
+
+private:
+    struct Entry
+    {
+        const uint8_t* font = nullptr;
+        uint32_t hash = 0;
+        uint32_t lastUse = 0;
+        int16_t width = 0;
+        uint8_t length = 0;
+        char text[MaxTextLength];
+    };
+
+    std::array<Entry, Capacity> _entries{};
+    uint32_t _useCounter = 0;
+    Statistics _statistics;
+
+    [[nodiscard]] static uint32_t hash(const char* text, size_t length);
+};
+
+}
@@ -0,0 +1,60 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "Transport.h"
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace U8W
+{
+
+// Host-side stand-in for a DMA transport: transfers are replayed on
+// a worker thread through a synchronous transport
+class ThreadedTransport : public Transport
+{
+public:
+    explicit ThreadedTransport(Transport& transport);
+    ~ThreadedTransport() override;
+
+    void init(uint32_t clockHz, uint8_t spiMode) override;
+    void setChipSelectLevel(bool level) override;
+    void setDataCommandLevel(bool level) override;
+    void write(const uint8_t* data, size_t length) override;
+
+    void transmit(const TransferBuffer& buffer, CompletionHandler onComplete) override;
+    void waitForCompletion() override;
+    [[nodiscard]] bool isBusy() const override;
+
+private:
+    Transport& _transport;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    const TransferBuffer* _buffer = nullptr;
+    CompletionHandler _onComplete;
+    bool _busy = false;
+    bool _stopping = false;
+
+    std::thread _thread;
+
+    void run();
+};
+
+}
@@ -0,0 +1,54 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace U8W
+{
+
+// Duration statistics in microseconds. Minimum, maximum and average
+// cover every sample since the last reset, percentiles are computed
+// from the most recent Capacity samples.
+class TimingWindow
+{
+public:
+    static constexpr size_t Capacity = 128;
+
+    void add(uint32_t us);
+    void reset();
+
+    [[nodiscard]] uint32_t count() const;
+    [[nodiscard]] uint32_t min() const;
+    [[nodiscard]] uint32_t max() const;
+    [[nodiscard]] uint32_t average() const;
+
+    // Nearest-rank percentile, percent is in the 0..100 range
+    [[nodiscard]] uint32_t percentile(int percent) const;
+
+private:
+    std::array<uint32_t, Capacity> _samples{};
+    size_t _next = 0;
+    uint32_t _count = 0;
+    uint32_t _min = 0;
+    uint32_t _max = 0;
+    uint64_t _sum = 0;
+};
+
+}
@@ -0,0 +1,83 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace U8W
+{
+
+// Records the bus operations of a display transfer, so they can be
+// replayed later by a Transport. Consecutive byte writes are merged
+// into one segment.
+class TransferBuffer
+{
+public:
+    enum class SegmentType : uint8_t
+    {
+        ChipSelect,
+        DataCommand,
+        Bytes
+    };
+
+    struct Segment
+    {
+        SegmentType type = SegmentType::Bytes;
+        bool level = false;
+        const uint8_t* data = nullptr;
+        size_t length = 0;
+    };
+
+    void clear();
+
+    void setChipSelectLevel(bool level);
+    void setDataCommandLevel(bool level);
+    void append(const uint8_t* data, size_t length);
+
+    [[nodiscard]] bool isEmpty() const;
+    [[nodiscard]] size_t size() const;
+
+    // Decodes the segment at the given offset and returns the offset
+    // of the next one
+    size_t read(size_t offset, Segment& segment) const;
+
+    template <typename Function>
+    void forEach(Function&& function) const
+    {
+        Segment segment;
+        size_t offset = 0;
+
+        while (offset < _data.size()) {
+            offset = read(offset, segment);
+            function(segment);
+        }
+    }
+
+private:
+    static constexpr size_t HeaderSize = 3;
+    static constexpr size_t MaxSegmentLength = 0xffff;
+    static constexpr size_t NoOpenSegment = static_cast<size_t>(-1);
+
+    std::vector<uint8_t> _data;
+    size_t _openSegment = NoOpenSegment;
+
+    void appendHeader(SegmentType type, uint16_t value);
+};
+
+}
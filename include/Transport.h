@@ -0,0 +1,56 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "TransferBuffer.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace U8W
+{
+
+// Byte-level bus used by Display to talk to the panel
+class Transport
+{
+public:
+    using CompletionHandler = std::function<void()>;
+
+    virtual ~Transport() = default;
+
+    virtual void init(uint32_t clockHz, uint8_t spiMode) = 0;
+    virtual void setChipSelectLevel(bool level) = 0;
+    virtual void setDataCommandLevel(bool level) = 0;
+    virtual void write(const uint8_t* data, size_t length) = 0;
+
+    // Sends a recorded transfer. The buffer must be kept intact until
+    // the completion handler is called. The handler may be called from
+    // another thread, or deferred to the next waitForCompletion(). The
+    // default implementation replays the transfer synchronously.
+    virtual void transmit(const TransferBuffer& buffer, CompletionHandler onComplete);
+
+    // Returns when the last transfer is done and its completion handler
+    // has returned
+    virtual void waitForCompletion() {}
+    [[nodiscard]] virtual bool isBusy() const { return false; }
+
+protected:
+    void replay(const TransferBuffer& buffer);
+};
+
+}
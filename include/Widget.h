@@ -16,18 +16,27 @@
 
 #pragma once
 
+#include "LatencyTracer.h"
 #include "Point.h"
 #include "Rect.h"
 #include "Size.h"
 
-#include <iostream>
-#include <string>
-#include <vector>
+#include <memory>
+
+// Widget names are only kept for debugging and profiling
+#ifndef U8W_WIDGET_NAMES
+#if !defined(NDEBUG) || U8W_RENDER_PROFILING || U8W_LATENCY_TRACING
+#define U8W_WIDGET_NAMES 1
+#else
+#define U8W_WIDGET_NAMES 0
+#endif
+#endif
 
 namespace U8W
 {
 
 class Display;
+class DisplayList;
 
 class Widget
 {
@@ -44,7 +53,17 @@ public:
     Widget& operator=(const Widget&) = delete;
     Widget& operator=(Widget&&) = delete;
 
-    void setName(std::string name);
+    // The name is not copied, it must outlive the widget
+    void setName(const char* name);
+
+    [[nodiscard]] inline const char* name() const
+    {
+#if U8W_WIDGET_NAMES
+        return _name;
+#else
+        return "";
+#endif
+    }
 
     const inline Point pos() const
     {
@@ -69,26 +88,120 @@ public:
 
     void setBackgroundEnabled(bool enabled);
 
+    // Hidden widgets and their subtrees are neither updated nor painted
+    void setVisible(bool visible);
+
+    enum class CacheMode
+    {
+        None,
+        // The widget's own pixels are cached
+        Bitmap,
+        // The pixels of the whole subtree are cached
+        BitmapWithChildren
+    };
+
+    // The rendered pixels are kept in the painter's bitmap cache and
+    // copied back on repaints until the widget (or a descendant, if the
+    // children are cached too) requests a repaint
+    void setCacheMode(CacheMode mode);
+
+    // The draw calls of paint() are recorded and replayed when the
+    // widget is repainted only because of its parent or the damage.
+    // The list is allocated here and grows on the heap while recording,
+    // re-recording keeps its capacity.
+    void setRetainedModeEnabled(bool enabled);
+
+    // True if the widget or a visible descendant waits for a repaint
+    [[nodiscard]] inline bool isRepaintPending() const
+    {
+        return _needsRepaint || _descendantNeedsRepaint;
+    }
+
+    [[nodiscard]] inline bool isVisible() const
+    {
+        return _visible;
+    }
+
     Point mapToGlobal(const Point& p) const;
     Rect mapToGlobal(const Rect& r) const;
+    Rect globalRect() const;
     Point mapToParent(const Point& p) const;
     Rect mapToParent(const Rect& r) const;
 
 protected:
     Display* const _display;
     Widget* const _parent;
-    std::string _name;
-    std::vector<Widget*> _children;
     Rect _rect;
     bool _needsRepaint = true;
     bool _parentNeedsRepaint = true;
     bool _backgroundEnabled = true;
+    bool _visible = true;
 
     virtual void paint();
 
+    // Schedules a repaint, the parent is repainted as well if the
+    // widget's geometry changed
+    void requestRepaint(bool parentToo = false);
+
+    // Schedules a repaint of an area in widget coordinates. A pending
+    // repaint of the whole widget is not narrowed.
+    void requestRepaint(const Rect& area);
+
     virtual void onResize() {};
 
     Rect calculateClipRect() const;
+
+private:
+#if U8W_WIDGET_NAMES
+    const char* _name = "";
+#endif
+
+    // Children are linked through their sibling pointers, in paint order
+    Widget* _firstChild = nullptr;
+    Widget* _lastChild = nullptr;
+    Widget* _previousSibling = nullptr;
+    Widget* _nextSibling = nullptr;
+
+    // Set if a widget in the subtree needs to be repainted, this lets the
+    // painter skip clean subtrees
+    bool _descendantNeedsRepaint = false;
+
+    // Global geometry, computed lazily from the parent's cached values
+    // and invalidated for the whole subtree on geometry changes
+    mutable Point _globalOffset;
+    mutable Rect _globalClipRect;
+    mutable bool _geometryValid = false;
+
+#if U8W_LATENCY_TRACING
+    // Time of the first invalidation since the last paint
+    uint64_t _invalidatedAt = 0;
+    bool _invalidationTraced = false;
+#endif
+
+    // Valid until the widget requests a repaint or its global geometry
+    // changes
+    std::unique_ptr<DisplayList> _displayList;
+    bool _displayListValid = false;
+
+    // Identifies the widget in the bitmap cache. Unlike the address it
+    // is never reused, so the bitmap of a destroyed widget is never
+    // found for a new one and ages out of the cache.
+    const uint32_t _cacheKey;
+    CacheMode _cacheMode = CacheMode::None;
+    bool _bitmapCacheValid = false;
+
+    // Area of a partial repaint in widget coordinates, see
+    // requestRepaint(const Rect&)
+    Rect _repaintArea;
+    bool _partialRepaint = false;
+
+    // Clip rectangle at the last damage collection, this is the area to
+    // repaint when the widget moves away
+    Rect _damageRect;
+
+    void markNeedsRepaint(bool parentToo);
+    void invalidateGeometry();
+    void updateGeometry() const;
 };
 
 }
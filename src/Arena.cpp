@@ -0,0 +1,68 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+#include "Arena.h"
+
+namespace U8W
+{
+
+Arena::Arena(uint8_t* const buffer, const size_t capacity)
+    : _buffer{ buffer }
+    , _capacity{ capacity }
+{}
+
+Arena::~Arena()
+{
+    reset();
+}
+
+void Arena::reset()
+{
+    while (_last) {
+        auto* const entry = _last;
+        _last = entry->previous;
+        entry->destroy(entry->object);
+    }
+
+    _used = 0;
+}
+
+size_t Arena::used() const
+{
+    return _used;
+}
+
+size_t Arena::capacity() const
+{
+    return _capacity;
+}
+
+void* Arena::allocate(const size_t size, const size_t alignment)
+{
+    const auto address = reinterpret_cast<uintptr_t>(_buffer) + _used;
+    const auto padding = (alignment - address % alignment) % alignment;
+
+    if (padding + size > _capacity - _used) {
+        return nullptr;
+    }
+
+    _used += padding + size;
+
+    return reinterpret_cast<void*>(address + padding);
+}
+
+}
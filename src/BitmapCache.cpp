@@ -0,0 +1,160 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "BitmapCache.h"
+
+namespace U8W
+{
+
+namespace
+{
+
+size_t bitmapSize(const Rect& rect)
+{
+    return static_cast<size_t>((rect.width() + 7) / 8) * rect.height();
+}
+
+}
+
+void BitmapCache::setBudget(const size_t bytes)
+{
+    _budget = bytes;
+    shrinkTo(bytes);
+}
+
+size_t BitmapCache::budget() const
+{
+    return _budget;
+}
+
+bool BitmapCache::isEnabled() const
+{
+    return _budget > 0;
+}
+
+const uint8_t* BitmapCache::find(const uint32_t key, const Rect& rect)
+{
+    for (auto& entry : _entries) {
+        if (entry.key == key && entry.valid && entry.rect == rect) {
+            entry.lastUse = ++_useCounter;
+            ++_statistics.hits;
+            return entry.bits.data();
+        }
+    }
+
+    ++_statistics.misses;
+    return nullptr;
+}
+
+uint8_t* BitmapCache::insert(const uint32_t key, const Rect& rect)
+{
+    const auto size = bitmapSize(rect);
+
+    // Recapturing a widget of the same size reuses its buffer, so
+    // steady-state repaints don't allocate
+    for (auto& entry : _entries) {
+        if (entry.key == key && entry.bits.size() == size && !rect.isEmpty()) {
+            entry.rect = rect;
+            entry.lastUse = ++_useCounter;
+            entry.valid = true;
+            return entry.bits.data();
+        }
+    }
+
+    remove(key);
+
+    if (rect.isEmpty() || size > _budget) {
+        return nullptr;
+    }
+
+    shrinkTo(_budget - size);
+
+    _entries.push_back(Entry{ key, rect, ++_useCounter, true, std::vector<uint8_t>(size) });
+    _statistics.bytesHeld += size;
+
+    return _entries.back().bits.data();
+}
+
+void BitmapCache::invalidate(const uint32_t key)
+{
+    for (auto& entry : _entries) {
+        if (entry.key == key) {
+            entry.valid = false;
+            return;
+        }
+    }
+}
+
+void BitmapCache::remove(const uint32_t key)
+{
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        if (_entries[i].key == key) {
+            _statistics.bytesHeld -= _entries[i].bits.size();
+            removeAt(i);
+            return;
+        }
+    }
+}
+
+void BitmapCache::clear()
+{
+    _entries.clear();
+    _statistics.bytesHeld = 0;
+}
+
+const BitmapCache::Statistics& BitmapCache::statistics() const
+{
+    return _statistics;
+}
+
+void BitmapCache::resetStatistics()
+{
+    _statistics = Statistics{ 0, 0, 0, _statistics.bytesHeld };
+}
+
+void BitmapCache::evict(const size_t index)
+{
+    _statistics.bytesHeld -= _entries[index].bits.size();
+    ++_statistics.evictions;
+
+    removeAt(index);
+}
+
+void BitmapCache::removeAt(const size_t index)
+{
+    if (index + 1 < _entries.size()) {
+        _entries[index] = std::move(_entries.back());
+    }
+
+    _entries.pop_back();
+}
+
+void BitmapCache::shrinkTo(const size_t bytes)
+{
+    while (_statistics.bytesHeld > bytes) {
+        size_t oldest = 0;
+
+        for (size_t i = 1; i < _entries.size(); ++i) {
+            if (_entries[i].lastUse < _entries[oldest].lastUse) {
+                oldest = i;
+            }
+        }
+
+        evict(oldest);
+    }
+}
+
+}
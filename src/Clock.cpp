@@ -0,0 +1,46 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "Clock.h"
+
+#include <chrono>
+
+namespace U8W
+{
+
+uint64_t SteadyClock::microseconds() const
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()
+    ).count();
+}
+
+uint64_t ManualClock::microseconds() const
+{
+    return _us;
+}
+
+void ManualClock::setMicroseconds(const uint64_t us)
+{
+    _us = us;
+}
+
+void ManualClock::advance(const uint64_t us)
+{
+    _us += us;
+}
+
+}
@@ -0,0 +1,112 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "CoalescingTransport.h"
+
+#include <cstring>
+
+namespace U8W
+{
+
+CoalescingTransport::CoalescingTransport(Transport& transport, const size_t capacity)
+    : _transport{ transport }
+    , _buffer(capacity)
+{}
+
+CoalescingTransport::~CoalescingTransport()
+{
+    flush();
+}
+
+void CoalescingTransport::init(const uint32_t clockHz, const uint8_t spiMode)
+{
+    flush();
+    _transport.init(clockHz, spiMode);
+}
+
+void CoalescingTransport::setChipSelectLevel(const bool level)
+{
+    flush();
+    _transport.setChipSelectLevel(level);
+}
+
+void CoalescingTransport::setDataCommandLevel(const bool level)
+{
+    flush();
+    _transport.setDataCommandLevel(level);
+}
+
+void CoalescingTransport::write(const uint8_t* const data, const size_t length)
+{
+    ++_statistics.writesReceived;
+    _statistics.bytes += length;
+
+    if (_length + length > _buffer.size()) {
+        ++_statistics.splits;
+        flush();
+
+        // Too large to be staged, pass it through
+        if (length > _buffer.size()) {
+            ++_statistics.writesIssued;
+            _transport.write(data, length);
+            return;
+        }
+    }
+
+    std::memcpy(_buffer.data() + _length, data, length);
+    _length += length;
+}
+
+void CoalescingTransport::transmit(const TransferBuffer& buffer, CompletionHandler onComplete)
+{
+    // Recorded transfers are already merged by TransferBuffer
+    flush();
+    _transport.transmit(buffer, std::move(onComplete));
+}
+
+void CoalescingTransport::waitForCompletion()
+{
+    flush();
+    _transport.waitForCompletion();
+}
+
+bool CoalescingTransport::isBusy() const
+{
+    return _transport.isBusy();
+}
+
+const CoalescingTransport::Statistics& CoalescingTransport::statistics() const
+{
+    return _statistics;
+}
+
+void CoalescingTransport::resetStatistics()
+{
+    _statistics = {};
+}
+
+void CoalescingTransport::flush()
+{
+    if (_length == 0) {
+        return;
+    }
+
+    ++_statistics.writesIssued;
+    _transport.write(_buffer.data(), _length);
+    _length = 0;
+}
+
+}
@@ -0,0 +1,58 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "CountingTransport.h"
+
+namespace U8W
+{
+
+CountingTransport::CountingTransport(const bool chipSelectActiveLevel)
+    : _chipSelectActiveLevel{ chipSelectActiveLevel }
+    , _chipSelectLevel{ !chipSelectActiveLevel }
+{}
+
+void CountingTransport::init(uint32_t, uint8_t)
+{}
+
+void CountingTransport::setChipSelectLevel(const bool level)
+{
+    if (level == _chipSelectActiveLevel && _chipSelectLevel != level) {
+        ++_statistics.transfers;
+    }
+
+    _chipSelectLevel = level;
+}
+
+void CountingTransport::setDataCommandLevel(bool)
+{}
+
+void CountingTransport::write(const uint8_t*, const size_t length)
+{
+    ++_statistics.writes;
+    _statistics.bytes += length;
+}
+
+const CountingTransport::Statistics& CountingTransport::statistics() const
+{
+    return _statistics;
+}
+
+void CountingTransport::resetStatistics()
+{
+    _statistics = {};
+}
+
+}
@@ -15,117 +15,332 @@
 //  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
 
 #include "Display.h"
+#include "DisplayBackend.h"
+#include "DisplayList.h"
+#include "FrameBuffer.h"
+#include "GlyphAtlas.h"
+#include "LatencyTracer.h"
+#include "TextWidthCache.h"
+#include "TransferBuffer.h"
+#include "Transport.h"
+#include "Utils.h"
 
 #include "../Fonts.h"
 
-#include <hardware/gpio.h>
-#include <hardware/pwm.h>
-#include <hardware/spi.h>
-
-#include <pico/time.h>
-
 #include <u8g2.h>
 #include <u8x8.h>
 
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
 #include <memory>
+#include <vector>
 
 namespace U8W
 {
 
-namespace Pins
+// Keeps track of the 8x8 tiles modified since the last transfer, one
+// bit per tile column. The size follows the u8g2 tile buffer.
+class DirtyTiles
 {
-    constexpr auto CS = 5;
-    constexpr auto DC = 8;
-    constexpr auto RST = 9;
+public:
+    static constexpr auto MaxColumns = 32;
+    static constexpr auto MaxRows = 32;
+
+    // Returns false if the size exceeds the limits
+    bool setSize(const int columns, const int rows)
+    {
+        _columns = Utils::clamp(columns, 0, MaxColumns);
+        _rows = Utils::clamp(rows, 0, MaxRows);
+        _mask.fill(0);
 
-    constexpr auto BacklightPwm = 0;
+        return _columns == columns && _rows == rows;
+    }
 
-    namespace SPI0
+    [[nodiscard]] int columns() const
     {
-        constexpr auto RX = 4;
-        constexpr auto CS = 5;
-        constexpr auto SCK = 6;
-        constexpr auto TX = 7;
+        return _columns;
     }
-}
 
-extern "C" uint8_t u8x8_d_st7586s_erc240160_chunked(
-    u8x8_t* const u8x8,
-    const uint8_t msg,
-    const uint8_t arg_int,
-    void* const arg_ptr
-);
+    [[nodiscard]] int rows() const
+    {
+        return _rows;
+    }
+
+    [[nodiscard]] int tileCount() const
+    {
+        return _columns * _rows;
+    }
+
+    void mark(const Rect& r)
+    {
+        if (r.isEmpty() || tileCount() == 0) {
+            return;
+        }
+
+        const auto x1 = Utils::clamp(r.left() / 8, 0, _columns - 1);
+        const auto x2 = Utils::clamp(r.right() / 8, 0, _columns - 1);
+        const auto y1 = Utils::clamp(r.top() / 8, 0, _rows - 1);
+        const auto y2 = Utils::clamp(r.bottom() / 8, 0, _rows - 1);
+
+        const auto columnMask = columnsMask(x2 - x1 + 1) << x1;
+
+        for (auto y = y1; y <= y2; ++y) {
+            _mask[y] |= columnMask;
+        }
+    }
+
+    void markAll()
+    {
+        std::fill_n(_mask.begin(), _rows, columnsMask(_columns));
+    }
+
+    void reset()
+    {
+        _mask.fill(0);
+    }
+
+    [[nodiscard]] uint32_t row(const int y) const
+    {
+        return _mask[y];
+    }
+
+    void setRow(const int y, const uint32_t columns)
+    {
+        _mask[y] = columns;
+    }
+
+    [[nodiscard]] int count() const
+    {
+        auto n = 0;
+
+        for (auto y = 0; y < _rows; ++y) {
+            n += __builtin_popcount(_mask[y]);
+        }
+
+        return n;
+    }
+
+private:
+    int _columns = 0;
+    int _rows = 0;
+    std::array<uint32_t, MaxRows> _mask{};
+
+    static uint32_t columnsMask(const int count)
+    {
+        return count >= 32 ? ~0u : (1u << count) - 1;
+    }
+};
+
+struct Display::Private
+{
+    // Must be the first member, the u8x8 callbacks rely on it
+    u8g2_t u8g2;
 
-extern "C" uint8_t u8x8_byte_hw_spi0_pico(
+    DisplayBackend* backend = nullptr;
+    Transport* transport = nullptr;
+
+    UpdateMode updateMode = UpdateMode::Synchronous;
+    std::array<TransferBuffer, 2> transferBuffers;
+    int nextTransferBuffer = 0;
+    TransferBuffer* recording = nullptr;
+    std::function<void()> updateCompletedCallback;
+
+    LatencyTracer* latencyTracer = nullptr;
+
+    DisplayList* displayList = nullptr;
+
+    void recordRect(const Rect& r)
+    {
+        displayList->addInt(r.x());
+        displayList->addInt(r.y());
+        displayList->addInt(r.width());
+        displayList->addInt(r.height());
+    }
+
+    void frameSubmitted()
+    {
+#if U8W_LATENCY_TRACING
+        if (latencyTracer) {
+            latencyTracer->frameSubmitted();
+        }
+#endif
+    }
+
+    // The painted pixels didn't change the panel content
+    void frameSkipped()
+    {
+#if U8W_LATENCY_TRACING
+        if (latencyTracer) {
+            latencyTracer->frameSkipped();
+        }
+#endif
+    }
+
+    void frameTransferred()
+    {
+#if U8W_LATENCY_TRACING
+        if (latencyTracer) {
+            latencyTracer->frameTransferred();
+        }
+#endif
+
+        if (updateCompletedCallback) {
+            updateCompletedCallback();
+        }
+    }
+
+    DirtyTiles dirtyTiles;
+
+    // Shadow of the u8g2 drawing state, -1 means unknown
+    Rect clipRect;
+    const uint8_t* fontData = nullptr;
+    int drawColor = -1;
+    int fontMode = -1;
+    StateCacheStatistics stateCacheStatistics;
+
+    TextWidthCache textWidthCache;
+
+    // Direct framebuffer access, null if the buffer layout is not supported
+    FrameBuffer frameBuffer;
+
+    GlyphAtlas glyphAtlas;
+    std::array<const uint8_t*, 8> glyphAtlasFonts{};
+
+    [[nodiscard]] bool useGlyphAtlas() const
+    {
+        if (frameBuffer.isNull() || !glyphAtlas.isEnabled()) {
+            return false;
+        }
+
+        for (const auto* const font : glyphAtlasFonts) {
+            if (font && font == fontData) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    [[nodiscard]] Rect textBounds(const Point& pos, int advance) const;
+    void drawTextFromAtlas(const Point& pos, const char* text);
+
+    bool stateChanged(const bool changed)
+    {
+        if (changed) {
+            ++stateCacheStatistics.misses;
+        } else {
+            ++stateCacheStatistics.hits;
+        }
+
+        return changed;
+    }
+
+    int fullUpdateThresholdPercent = 50;
+    bool fullUpdatesOnly = false;
+    std::vector<uint8_t> shadowBuffer;
+    bool shadowBufferValid = false;
+    UpdateStatistics updateStatistics;
+
+    DrawStatistics drawStatistics;
+
+    void markDirty(const Rect& r)
+    {
+        ++drawStatistics.drawCalls;
+        touch(r);
+    }
+
+    void touch(const Rect& r)
+    {
+        const auto touched = r & clipRect;
+
+        if (!touched.isEmpty()) {
+            drawStatistics.pixelsTouched += touched.width() * touched.height();
+            dirtyTiles.mark(touched);
+        }
+    }
+
+    [[nodiscard]] int bufferStride()
+    {
+        return u8g2_GetBufferTileWidth(&u8g2);
+    }
+
+    [[nodiscard]] int bufferSize()
+    {
+        return bufferStride() * u8g2_GetBufferTileHeight(&u8g2) * 8;
+    }
+
+    void discardUnchangedTiles();
+    void updateShadowBuffer();
+    int sendDirtyTiles();
+
+    static uint8_t byteCallback(
+        u8x8_t* u8x8,
+        uint8_t msg,
+        uint8_t arg_int,
+        void* arg_ptr
+    );
+};
+
+uint8_t Display::Private::byteCallback(
     u8x8_t* const u8x8,
     const uint8_t msg,
     const uint8_t arg_int,
     void* const arg_ptr
 )
 {
+    // u8x8_t is the first member of u8g2_t, which is the first member
+    // of Private
+    auto* const p = reinterpret_cast<Private*>(u8x8);
+    auto* const recording = p->recording;
+
     switch (msg)
     {
         case U8X8_MSG_BYTE_SEND:
-            spi_write_blocking(spi0, (uint8_t *)arg_ptr, arg_int);
+            if (recording) {
+                recording->append(static_cast<const uint8_t*>(arg_ptr), arg_int);
+            } else {
+                p->transport->write(static_cast<const uint8_t*>(arg_ptr), arg_int);
+            }
             break;
 
         case U8X8_MSG_BYTE_INIT:
             if (u8x8->bus_clock == 0) /* issue 769 */
                 u8x8->bus_clock = u8x8->display_info->sck_clock_hz;
-            /* disable chipselect */
-            u8x8_gpio_SetCS(u8x8, u8x8->display_info->chip_disable_level);
-
-            /* no wait required here */
-            /* for SPI: setup correct level of the clock signal */
-            spi_set_format(
-                spi0,
-                8,
-                [&] {
-                    switch (u8x8->display_info->spi_mode)
-                    {
-                        case 0:
-                        case 1:
-                        default:
-                            return SPI_CPOL_0;
-                        case 2:
-                        case 3:
-                            return SPI_CPOL_1;
-                    }
-                }(),
-                [&] {
-                    switch (u8x8->display_info->spi_mode)
-                    {
-                        case 0:
-                        case 2:
-                        default:
-                            return SPI_CPHA_0;
-                        case 1:
-                        case 3:
-                            return SPI_CPHA_1;
-                    }
-                }(),
-                SPI_MSB_FIRST
-            );
 
-            gpio_set_function(Pins::SPI0::RX, GPIO_FUNC_SPI);
-            gpio_set_function(Pins::SPI0::SCK, GPIO_FUNC_SPI);
-            gpio_set_function(Pins::SPI0::TX, GPIO_FUNC_SPI);
-
-            spi_init(spi0, 60'000'000);
+            p->transport->waitForCompletion();
+            p->transport->setChipSelectLevel(u8x8->display_info->chip_disable_level);
+            p->transport->init(60'000'000, u8x8->display_info->spi_mode);
             break;
 
         case U8X8_MSG_BYTE_SET_DC:
-            u8x8_gpio_SetDC(u8x8, arg_int);
+            if (recording) {
+                recording->setDataCommandLevel(arg_int);
+            } else {
+                p->transport->setDataCommandLevel(arg_int);
+            }
             break;
 
         case U8X8_MSG_BYTE_START_TRANSFER:
-            u8x8_gpio_SetCS(u8x8, u8x8->display_info->chip_enable_level);
-            u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_DELAY_NANO, u8x8->display_info->post_chip_enable_wait_ns, NULL);
+            if (recording) {
+                recording->setChipSelectLevel(u8x8->display_info->chip_enable_level);
+            } else {
+                // Synchronous traffic must not interleave with a frame
+                // which is still in flight
+                p->transport->waitForCompletion();
+                p->transport->setChipSelectLevel(u8x8->display_info->chip_enable_level);
+                u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_DELAY_NANO, u8x8->display_info->post_chip_enable_wait_ns, NULL);
+            }
             break;
 
         case U8X8_MSG_BYTE_END_TRANSFER:
-            u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_DELAY_NANO, u8x8->display_info->pre_chip_disable_wait_ns, NULL);
-            u8x8_gpio_SetCS(u8x8, u8x8->display_info->chip_disable_level);
+            if (recording) {
+                recording->setChipSelectLevel(u8x8->display_info->chip_disable_level);
+            } else {
+                u8x8->gpio_and_delay_cb(u8x8, U8X8_MSG_DELAY_NANO, u8x8->display_info->pre_chip_disable_wait_ns, NULL);
+                p->transport->setChipSelectLevel(u8x8->display_info->chip_disable_level);
+            }
             break;
 
         default:
@@ -135,60 +350,216 @@ extern "C" uint8_t u8x8_byte_hw_spi0_pico(
     return 1;
 }
 
-extern "C" uint8_t u8x8_gpio_and_delay_pico(
-    u8x8_t* const u8g2,
-    const uint8_t msg,
-    const uint8_t arg_int,
-    void* const arg_ptr
-)
+namespace
 {
-    switch (msg)
-    {
-        case U8X8_MSG_GPIO_AND_DELAY_INIT:
-            gpio_init(Pins::CS);
-            gpio_init(Pins::DC);
-            gpio_init(Pins::RST);
-            gpio_set_dir(Pins::CS, true);
-            gpio_set_dir(Pins::DC, true);
-            gpio_set_dir(Pins::RST, true);
-            break;
 
-        case U8X8_MSG_DELAY_MILLI:
-            sleep_ms(arg_int);
-            break;
+Rect readRect(DisplayList::Reader& reader)
+{
+    const auto x = reader.readInt();
+    const auto y = reader.readInt();
+    const auto width = reader.readInt();
+    const auto height = reader.readInt();
 
-        case U8X8_MSG_GPIO_DC:
-            gpio_put(Pins::DC, !!arg_int);
-            break;
+    return Rect{ x, y, width, height };
+}
 
-        case U8X8_MSG_GPIO_CS:
-            gpio_put(Pins::CS, !!arg_int);
-            break;
+}
 
-        case U8X8_MSG_GPIO_RESET:
-            gpio_put(Pins::RST, !!arg_int);
-            break;
+Rect Display::Private::textBounds(const Point& pos, const int advance) const
+{
+    // The last glyph may extend beyond the advance, so the maximum glyph
+    // width is added to stay on the safe side
+    const auto& fontInfo = u8g2.font_info;
 
-        default:
-            return 0;
+    return Rect{
+        Point{
+            pos.x() + Utils::min<int>(0, fontInfo.x_offset),
+            pos.y() - fontInfo.max_char_height - fontInfo.y_offset
+        },
+        Point{
+            pos.x() + advance + fontInfo.max_char_width,
+            pos.y() - fontInfo.y_offset
+        }
+    };
+}
+
+void Display::Private::drawTextFromAtlas(const Point& pos, const char* text)
+{
+    ++drawStatistics.drawCalls;
+
+    auto x = pos.x();
+
+    for (; *text; ++text) {
+        const auto encoding = static_cast<uint8_t>(*text);
+        const auto* const glyph = glyphAtlas.find(fontData, encoding);
+
+        if (!glyph) {
+            // Too large for the atlas, u8g2 has to decode it
+            const Point glyphPos{ x, pos.y() };
+            const auto advance = u8g2_DrawGlyph(&u8g2, x, pos.y(), encoding);
+            touch(textBounds(glyphPos, advance));
+            x += advance;
+            continue;
+        }
+
+        const auto left = x + glyph->x;
+        const auto top = pos.y() + glyph->y;
+        x += glyph->advance;
+
+        // Partial repaints clip most glyphs of a text
+        if ((Rect{ left, top, glyph->width, glyph->height } & clipRect).isEmpty()) {
+            continue;
+        }
+
+        for (auto row = 0; row < glyph->height; ++row) {
+            frameBuffer.drawBits(
+                left,
+                top + row,
+                glyph->bits + row * glyph->stride(),
+                glyph->width,
+                drawColor,
+                fontMode == static_cast<int>(FontMode::Solid),
+                clipRect
+            );
+        }
+
+        touch(Rect{ left, top, glyph->width, glyph->height });
     }
+}
 
-    return 1;
+void Display::Private::discardUnchangedTiles()
+{
+    const auto* const buffer = u8g2_GetBufferPtr(&u8g2);
+    const auto stride = bufferStride();
+
+    for (auto ty = 0; ty < dirtyTiles.rows(); ++ty) {
+        const auto dirty = dirtyTiles.row(ty);
+
+        if (dirty == 0) {
+            continue;
+        }
+
+        // Each byte of a pixel row belongs to a different tile column,
+        // so one word covers four tiles
+        uint32_t changed = 0;
+
+        for (auto y = ty * 8; y < ty * 8 + 8; ++y) {
+            const auto* const current = buffer + y * stride;
+            const auto* const shadow = shadowBuffer.data() + y * stride;
+
+            auto x = 0;
+
+            for (; x + 4 <= stride; x += 4) {
+                uint32_t a, b;
+                std::memcpy(&a, current + x, sizeof(a));
+                std::memcpy(&b, shadow + x, sizeof(b));
+
+                if (a == b) {
+                    continue;
+                }
+
+                for (auto i = 0; i < 4; ++i) {
+                    if (current[x + i] != shadow[x + i]) {
+                        changed |= 1u << (x + i);
+                    }
+                }
+            }
+
+            for (; x < stride; ++x) {
+                if (current[x] != shadow[x]) {
+                    changed |= 1u << x;
+                }
+            }
+        }
+
+        updateStatistics.tilesCompared += __builtin_popcount(dirty);
+        dirtyTiles.setRow(ty, dirty & changed);
+    }
 }
 
-struct Display::Private
+void Display::Private::updateShadowBuffer()
 {
-    u8g2_t u8g2;
-};
+    const auto* const buffer = u8g2_GetBufferPtr(&u8g2);
+    const auto stride = bufferStride();
+
+    for (auto ty = 0; ty < dirtyTiles.rows(); ++ty) {
+        const auto row = dirtyTiles.row(ty);
+
+        if (row == 0) {
+            continue;
+        }
+
+        const auto first = __builtin_ctz(row);
+        const auto last = 31 - __builtin_clz(row);
+
+        for (auto y = ty * 8; y < ty * 8 + 8; ++y) {
+            std::memcpy(
+                shadowBuffer.data() + y * stride + first,
+                buffer + y * stride + first,
+                last - first + 1
+            );
+        }
+    }
+}
+
+int Display::Private::sendDirtyTiles()
+{
+    auto tilesSent = 0;
+
+    // Send the dirty span of each tile row, merging consecutive rows
+    // with identical spans into one window
+    auto y = 0;
+
+    while (y < dirtyTiles.rows()) {
+        const auto row = dirtyTiles.row(y);
+
+        if (row == 0) {
+            ++y;
+            continue;
+        }
 
-Display::Display()
+        const auto first = __builtin_ctz(row);
+        const auto last = 31 - __builtin_clz(row);
+
+        auto height = 1;
+
+        while (y + height < dirtyTiles.rows()) {
+            const auto next = dirtyTiles.row(y + height);
+
+            if (
+                next == 0
+                || __builtin_ctz(next) != first
+                || 31 - __builtin_clz(next) != last
+            ) {
+                break;
+            }
+
+            ++height;
+        }
+
+        u8g2_UpdateDisplayArea(&u8g2, first, y, last - first + 1, height);
+        tilesSent += (last - first + 1) * height;
+
+        y += height;
+    }
+
+    return tilesSent;
+}
+
+Display::Display(DisplayBackend& backend)
     : _p{ std::make_unique<Private>() }
 {
+    _p->backend = &backend;
+    _p->transport = &backend.transport();
+
     setup();
     setFont(Font{});
 }
 
-Display::~Display() = default;
+Display::~Display()
+{
+    waitForUpdate();
+}
 
 Size Display::size() const
 {
@@ -201,16 +572,177 @@ Size Display::size() const
 void Display::clear()
 {
     u8g2_ClearDisplay(&_p->u8g2);
+    _p->dirtyTiles.reset();
+
+    if (!_p->shadowBuffer.empty()) {
+        std::memcpy(
+            _p->shadowBuffer.data(),
+            u8g2_GetBufferPtr(&_p->u8g2),
+            _p->shadowBuffer.size()
+        );
+        _p->shadowBufferValid = true;
+    }
 }
 
 void Display::clearBuffer()
 {
     u8g2_ClearBuffer(&_p->u8g2);
+    _p->dirtyTiles.markAll();
 }
 
 void Display::update()
 {
-    u8g2_SendBuffer(&_p->u8g2);
+    if (_p->updateMode == UpdateMode::Asynchronous) {
+        // The recorded transfer serves as the snapshot of the frame,
+        // the framebuffer can be modified as soon as this returns
+        auto& buffer = _p->transferBuffers[_p->nextTransferBuffer];
+        buffer.clear();
+
+        _p->recording = &buffer;
+        const auto sent = sendChangedAreas();
+        _p->recording = nullptr;
+
+        if (!sent) {
+            _p->frameSkipped();
+            return;
+        }
+
+        // Back-pressure: only one frame can be in flight. This also
+        // serialises the completion handler of the previous frame with
+        // frameSubmitted() of this one.
+        _p->transport->waitForCompletion();
+
+        _p->frameSubmitted();
+        _p->transport->transmit(buffer, [p = _p.get()] {
+            p->frameTransferred();
+        });
+
+        _p->nextTransferBuffer ^= 1;
+    } else {
+        if (!sendChangedAreas()) {
+            _p->frameSkipped();
+            return;
+        }
+
+        // Nothing runs between the send and these, so the frame can be
+        // reported once it is out
+        _p->frameSubmitted();
+        _p->frameTransferred();
+    }
+}
+
+void Display::setUpdateMode(const UpdateMode mode)
+{
+    if (mode == UpdateMode::Synchronous) {
+        waitForUpdate();
+    }
+
+    _p->updateMode = mode;
+}
+
+void Display::waitForUpdate()
+{
+    _p->transport->waitForCompletion();
+}
+
+bool Display::isUpdateInProgress() const
+{
+    return _p->transport->isBusy();
+}
+
+void Display::setUpdateCompletedCallback(std::function<void()> callback)
+{
+    waitForUpdate();
+    _p->updateCompletedCallback = std::move(callback);
+}
+
+void Display::setLatencyTracer(LatencyTracer* const tracer)
+{
+    waitForUpdate();
+    _p->latencyTracer = tracer;
+}
+
+LatencyTracer* Display::latencyTracer() const
+{
+    return _p->latencyTracer;
+}
+
+bool Display::sendChangedAreas()
+{
+    const auto shadowBufferEnabled = !_p->shadowBuffer.empty();
+
+    if (shadowBufferEnabled && _p->shadowBufferValid) {
+        const auto dirtyTileCount = _p->dirtyTiles.count();
+        _p->discardUnchangedTiles();
+        _p->updateStatistics.bytesSaved += (dirtyTileCount - _p->dirtyTiles.count()) * 8;
+    }
+
+    const auto dirtyTileCount = _p->dirtyTiles.count();
+
+    if (dirtyTileCount == 0) {
+        return false;
+    }
+
+    if (dirtyTileCount * 100 >= _p->dirtyTiles.tileCount() * _p->fullUpdateThresholdPercent) {
+        u8g2_SendBuffer(&_p->u8g2);
+        _p->dirtyTiles.markAll();
+        _p->updateStatistics.tilesSent += _p->dirtyTiles.tileCount();
+    } else {
+        _p->updateStatistics.tilesSent += _p->sendDirtyTiles();
+    }
+
+    if (shadowBufferEnabled) {
+        _p->updateShadowBuffer();
+        _p->shadowBufferValid = true;
+    }
+
+    _p->dirtyTiles.reset();
+
+    return true;
+}
+
+void Display::setFullUpdateThreshold(const int percent)
+{
+    if (!_p->fullUpdatesOnly) {
+        _p->fullUpdateThresholdPercent = Utils::clamp(percent, 0, 100);
+    }
+}
+
+void Display::setShadowBufferEnabled(const bool enabled)
+{
+    // The tiles are compared through the dirty tile masks
+    if (!enabled || _p->fullUpdatesOnly) {
+        _p->shadowBuffer = {};
+        return;
+    }
+
+    if (_p->shadowBuffer.empty()) {
+        // The panel content is unknown, so the next update must send
+        // everything before the shadow can be trusted
+        _p->shadowBuffer.assign(_p->bufferSize(), 0);
+        _p->shadowBufferValid = false;
+        _p->dirtyTiles.markAll();
+    }
+}
+
+const Display::UpdateStatistics& Display::updateStatistics() const
+{
+    return _p->updateStatistics;
+}
+
+void Display::resetUpdateStatistics()
+{
+    _p->updateStatistics = {};
+}
+
+const Display::DrawStatistics& Display::drawStatistics() const
+{
+    return _p->drawStatistics;
+}
+
+void Display::resetDrawStatistics()
+{
+    _p->drawStatistics = {};
 }
 
 void Display::setContrast(const uint8_t value)
@@ -220,39 +752,111 @@ void Display::setContrast(const uint8_t value)
 
 void Display::setBacklightLevel(const uint8_t value)
 {
-    pwm_set_gpio_level(Pins::BacklightPwm, value * value);
+    _p->backend->setBacklightLevel(value);
 }
 
 void Display::setDrawColor(const Color color)
 {
-    u8g2_SetDrawColor(&_p->u8g2, static_cast<int>(color));
+    const auto value = static_cast<int>(color);
+
+    if (_p->displayList) {
+        _p->displayList->addOpcode(DisplayList::Opcode::SetDrawColor);
+        _p->displayList->addInt(value);
+    }
+
+    if (!_p->stateChanged(_p->drawColor != value)) {
+        return;
+    }
+
+    _p->drawColor = value;
+    u8g2_SetDrawColor(&_p->u8g2, value);
 }
 
 void Display::setFont(const Font& font)
 {
-    const auto *const data = font.data();
-    if (data != nullptr)
-    {
-        u8g2_SetFont(&_p->u8g2, data);
+    setFontData(font.data());
+}
+
+void Display::setFontData(const uint8_t* const data)
+{
+    if (data == nullptr) {
+        return;
+    }
+
+    if (_p->displayList) {
+        _p->displayList->addOpcode(DisplayList::Opcode::SetFont);
+        _p->displayList->addPointer(data);
+    }
+
+    // u8g2_SetFont() parses the font header, avoid it if possible
+    if (!_p->stateChanged(_p->fontData != data)) {
+        return;
+    }
+
+    _p->fontData = data;
+    u8g2_SetFont(&_p->u8g2, data);
+}
+
+void Display::setFontMode(const FontMode mode)
+{
+    const auto value = static_cast<int>(mode);
+
+    if (_p->displayList) {
+        _p->displayList->addOpcode(DisplayList::Opcode::SetFontMode);
+        _p->displayList->addInt(value);
+    }
+
+    if (!_p->stateChanged(_p->fontMode != value)) {
+        return;
     }
+
+    _p->fontMode = value;
+    u8g2_SetFontMode(&_p->u8g2, value);
 }
 
 void Display::setClipRect(const Rect& rect)
 {
+    const auto clipRect = rect & Rect{ Point{}, size() };
+
+    if (!_p->stateChanged(_p->clipRect != clipRect)) {
+        return;
+    }
+
+    _p->clipRect = clipRect;
+
+    // An empty window disables drawing
     u8g2_SetClipWindow(
         &_p->u8g2,
-        rect.x(),
-        rect.y(),
-        rect.x() + rect.width(),
-        rect.y() + rect.height()
+        clipRect.isEmpty() ? 0 : clipRect.x(),
+        clipRect.isEmpty() ? 0 : clipRect.y(),
+        clipRect.isEmpty() ? 0 : clipRect.x() + clipRect.width(),
+        clipRect.isEmpty() ? 0 : clipRect.y() + clipRect.height()
     );
 }
 
 void Display::resetClipRect()
 {
+    const auto clipRect = Rect{ Point{}, size() };
+
+    if (!_p->stateChanged(_p->clipRect != clipRect)) {
+        return;
+    }
+
+    _p->clipRect = clipRect;
+
     u8g2_SetMaxClipWindow(&_p->u8g2);
 }
 
+const Display::StateCacheStatistics& Display::stateCacheStatistics() const
+{
+    return _p->stateCacheStatistics;
+}
+
+void Display::resetStateCacheStatistics()
+{
+    _p->stateCacheStatistics = {};
+}
+
 int Display::calculateFontAscent() const
 {
     return u8g2_GetAscent(&_p->u8g2);
@@ -270,12 +874,92 @@ int Display::calculateMaxCharHeight() const
 
 int Display::calculateTextWidth(const std::string& text) const
 {
-    return u8g2_GetStrWidth(&_p->u8g2, text.c_str());
+    return calculateTextWidth(text.c_str());
+}
+
+int Display::calculateTextWidth(const char* const text) const
+{
+    auto& cache = _p->textWidthCache;
+    const auto length = std::strlen(text);
+
+    auto width = cache.find(_p->fontData, text, length);
+
+    if (width < 0) {
+        width = u8g2_GetStrWidth(&_p->u8g2, text);
+        cache.insert(_p->fontData, text, length, width);
+    }
+
+    return width;
+}
+
+const TextWidthCache::Statistics& Display::textWidthCacheStatistics() const
+{
+    return _p->textWidthCache.statistics();
+}
+
+void Display::resetTextWidthCacheStatistics()
+{
+    _p->textWidthCache.resetStatistics();
 }
 
 void Display::drawText(const Point &pos, const std::string& s)
 {
-    u8g2_DrawStr(&_p->u8g2, pos.x(), pos.y(), s.c_str());
+    drawText(pos, s.c_str());
+}
+
+void Display::drawText(const Point& pos, const char* const s)
+{
+    if (_p->displayList) {
+        _p->displayList->addOpcode(DisplayList::Opcode::DrawText);
+        _p->displayList->addInt(pos.x());
+        _p->displayList->addInt(pos.y());
+        _p->displayList->addText(s);
+    }
+
+    if (_p->useGlyphAtlas()) {
+        _p->drawTextFromAtlas(pos, s);
+        return;
+    }
+
+    const auto advance = u8g2_DrawStr(&_p->u8g2, pos.x(), pos.y(), s);
+    _p->markDirty(_p->textBounds(pos, advance));
+}
+
+void Display::setGlyphAtlasBudget(const size_t bytes)
+{
+    _p->glyphAtlas.setBudget(bytes);
+}
+
+void Display::setGlyphAtlasEnabled(const Font& font, const bool enabled)
+{
+    const auto* const data = font.data();
+
+    for (auto& entry : _p->glyphAtlasFonts) {
+        if (entry == data) {
+            entry = nullptr;
+        }
+    }
+
+    if (!enabled) {
+        return;
+    }
+
+    for (auto& entry : _p->glyphAtlasFonts) {
+        if (!entry) {
+            entry = data;
+            return;
+        }
+    }
+}
+
+const GlyphAtlas::Statistics& Display::glyphAtlasStatistics() const
+{
+    return _p->glyphAtlas.statistics();
+}
+
+void Display::resetGlyphAtlasStatistics()
+{
+    _p->glyphAtlas.resetStatistics();
 }
 
 void Display::drawBitmap(
@@ -285,17 +969,65 @@ void Display::drawBitmap(
     const uint8_t* const data
 )
 {
-    u8g2_DrawXBM(&_p->u8g2, pos.x(), pos.y(), width, height, data);
+    if (_p->displayList) {
+        _p->displayList->addOpcode(DisplayList::Opcode::DrawBitmap);
+        _p->displayList->addInt(pos.x());
+        _p->displayList->addInt(pos.y());
+        _p->displayList->addInt(width);
+        _p->displayList->addInt(height);
+        _p->displayList->addPointer(data);
+    }
+
+    if (_p->frameBuffer.isNull()) {
+        u8g2_DrawXBM(&_p->u8g2, pos.x(), pos.y(), width, height, data);
+    } else {
+        _p->frameBuffer.drawXbm(
+            pos.x(),
+            pos.y(),
+            width,
+            height,
+            data,
+            _p->drawColor,
+            _p->u8g2.bitmap_transparency == 0,
+            _p->clipRect
+        );
+    }
+
+    _p->markDirty(Rect{ pos, Size{ width, height } });
 }
 
 void Display::drawRect(const Rect& rect)
 {
+    if (_p->displayList) {
+        _p->displayList->addOpcode(DisplayList::Opcode::DrawRect);
+        _p->recordRect(rect);
+    }
+
     u8g2_DrawFrame(&_p->u8g2, rect.x(), rect.y(), rect.width(), rect.height());
+
+    // Only the edges are touched
+    ++_p->drawStatistics.drawCalls;
+    _p->touch(Rect{ rect.topLeft(), rect.topRight() });
+    _p->touch(Rect{ rect.bottomLeft(), rect.bottomRight() });
+    _p->touch(Rect{ rect.topLeft(), rect.bottomLeft() });
+    _p->touch(Rect{ rect.topRight(), rect.bottomRight() });
 }
 
 void Display::drawLine(const Point& from, const Point& to)
 {
+    if (_p->displayList) {
+        _p->displayList->addOpcode(DisplayList::Opcode::DrawLine);
+        _p->displayList->addInt(from.x());
+        _p->displayList->addInt(from.y());
+        _p->displayList->addInt(to.x());
+        _p->displayList->addInt(to.y());
+    }
+
     u8g2_DrawLine(&_p->u8g2, from.x(), from.y(), to.x(), to.y());
+    _p->markDirty(Rect{
+        Point{ Utils::min(from.x(), to.x()), Utils::min(from.y(), to.y()) },
+        Point{ Utils::max(from.x(), to.x()), Utils::max(from.y(), to.y()) }
+    });
 }
 
 void Display::drawLine(
@@ -305,12 +1037,127 @@ void Display::drawLine(
     const uint8_t y2
 )
 {
-    u8g2_DrawLine(&_p->u8g2, x1, y1, x2, y2);
+    drawLine(Point{ x1, y1 }, Point{ x2, y2 });
 }
 
 void Display::fillRect(const Rect& rect)
 {
-    u8g2_DrawBox(&_p->u8g2, rect.x(), rect.y(), rect.width(), rect.height());
+    if (_p->displayList) {
+        _p->displayList->addOpcode(DisplayList::Opcode::FillRect);
+        _p->recordRect(rect);
+    }
+
+    if (_p->frameBuffer.isNull()) {
+        u8g2_DrawBox(&_p->u8g2, rect.x(), rect.y(), rect.width(), rect.height());
+    } else {
+        _p->frameBuffer.fillRect(rect, _p->drawColor, _p->clipRect);
+    }
+
+    _p->markDirty(rect);
+}
+
+bool Display::readPixels(const Rect& rect, uint8_t* const data) const
+{
+    if (_p->frameBuffer.isNull() || (rect & _p->frameBuffer.rect()) != rect) {
+        return false;
+    }
+
+    _p->frameBuffer.copyRect(rect, data);
+
+    return true;
+}
+
+void Display::writePixels(const Rect& rect, const uint8_t* const data)
+{
+    if (_p->frameBuffer.isNull()) {
+        return;
+    }
+
+    const auto stride = (rect.width() + 7) / 8;
+
+    for (auto row = 0; row < rect.height(); ++row) {
+        _p->frameBuffer.drawBits(
+            rect.x(),
+            rect.y() + row,
+            data + row * stride,
+            rect.width(),
+            1,
+            true,
+            _p->clipRect
+        );
+    }
+
+    _p->markDirty(rect);
+}
+
+void Display::beginRecording(DisplayList* const list)
+{
+    _p->displayList = list;
+}
+
+void Display::endRecording()
+{
+    _p->displayList = nullptr;
+}
+
+void Display::replay(const DisplayList& list)
+{
+    // Replaying into a list being recorded appends the commands to it
+    DisplayList::Reader reader{ list };
+
+    while (!reader.atEnd()) {
+        switch (reader.readOpcode()) {
+            case DisplayList::Opcode::SetDrawColor:
+                setDrawColor(static_cast<Color>(reader.readInt()));
+                break;
+
+            case DisplayList::Opcode::SetFont:
+                setFontData(static_cast<const uint8_t*>(reader.readPointer()));
+                break;
+
+            case DisplayList::Opcode::SetFontMode:
+                setFontMode(static_cast<FontMode>(reader.readInt()));
+                break;
+
+            case DisplayList::Opcode::DrawText: {
+                const auto x = reader.readInt();
+                const auto y = reader.readInt();
+                drawText(Point{ x, y }, reader.readText());
+                break;
+            }
+
+            case DisplayList::Opcode::DrawBitmap: {
+                const auto x = reader.readInt();
+                const auto y = reader.readInt();
+                const auto width = reader.readInt();
+                const auto height = reader.readInt();
+                drawBitmap(
+                    Point{ x, y },
+                    width,
+                    height,
+                    static_cast<const uint8_t*>(reader.readPointer())
+                );
+                break;
+            }
+
+            case DisplayList::Opcode::DrawRect:
+                drawRect(readRect(reader));
+                break;
+
+            case DisplayList::Opcode::DrawLine: {
+                const auto x1 = reader.readInt();
+                const auto y1 = reader.readInt();
+                const auto x2 = reader.readInt();
+                const auto y2 = reader.readInt();
+                drawLine(Point{ x1, y1 }, Point{ x2, y2 });
+                break;
+            }
+
+            case DisplayList::Opcode::FillRect:
+                fillRect(readRect(reader));
+                break;
+        }
+    }
 }
 
 void Display::setup()
@@ -320,13 +1167,7 @@ void Display::setup()
     uint8_t tileBufHeight;
     uint8_t* buf = nullptr;
 
-    u8g2_SetupDisplay(
-        &_p->u8g2,
-        u8x8_d_st7586s_erc240160_chunked,
-        u8x8_cad_011,
-        u8x8_byte_hw_spi0_pico,
-        u8x8_gpio_and_delay_pico
-    );
+    _p->backend->setupDisplay(&_p->u8g2, &Private::byteCallback);
 
     printf("u8g2_SetupDisplay OK\r\n");
 
@@ -342,19 +1183,45 @@ void Display::setup()
 
     printf("u8g2_SetupBuffer OK\r\n");
 
-    // Setup the backlight control PWM pin
-    gpio_set_function(Pins::BacklightPwm, GPIO_FUNC_PWM);
-    const auto blPwmPinSlice = pwm_gpio_to_slice_num(Pins::BacklightPwm);
-    auto blPwmConfig = pwm_get_default_config();
-    pwm_config_set_clkdiv(&blPwmConfig, 4.f);
-    pwm_config_set_wrap(&blPwmConfig, 255 * 255);
-    pwm_init(blPwmPinSlice, &blPwmConfig, true);
-    // setBacklightLevel(60);
+    const auto tilesFit = _p->dirtyTiles.setSize(
+        u8g2_GetBufferTileWidth(&_p->u8g2),
+        u8g2_GetBufferTileHeight(&_p->u8g2)
+    );
+
+    // The changed areas can't be tracked, every update sends the whole
+    // buffer
+    if (!tilesFit) {
+        printf("Display: tile buffer too large for dirty tracking\r\n");
+        _p->fullUpdatesOnly = true;
+        _p->fullUpdateThresholdPercent = 0;
+    }
+
+    // The direct drawing paths assume this exact layout, other rotations
+    // fall back to the u8g2 drawing functions
+    if (_p->u8g2.cb == U8G2_R0) {
+        _p->frameBuffer = FrameBuffer{
+            buf,
+            u8g2_GetDisplayWidth(&_p->u8g2),
+            u8g2_GetDisplayHeight(&_p->u8g2),
+            u8g2_GetBufferTileWidth(&_p->u8g2)
+        };
+    }
+
+    _p->backend->init();
 
     u8g2_InitDisplay(&_p->u8g2);
     u8g2_SetPowerSave(&_p->u8g2, 0);
     u8g2_SetContrast(&_p->u8g2, 60);
 
+    _p->clipRect = Rect{ Point{}, size() };
+
+    // Make the shadowed state known, these are the u8g2 defaults
+    setDrawColor(Color::Black);
+    setFontMode(FontMode::Solid);
+
+    // The panel content is unknown after initialization
+    _p->dirtyTiles.markAll();
+
     printf("%s OK\r\n", __FUNCTION__);
 }
 
@@ -0,0 +1,108 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "DisplayList.h"
+
+#include <cstring>
+
+namespace U8W
+{
+
+void DisplayList::clear()
+{
+    _data.clear();
+}
+
+bool DisplayList::isEmpty() const
+{
+    return _data.empty();
+}
+
+size_t DisplayList::sizeInBytes() const
+{
+    return _data.size();
+}
+
+void DisplayList::addOpcode(const Opcode opcode)
+{
+    _data.push_back(static_cast<uint8_t>(opcode));
+}
+
+void DisplayList::addInt(const int value)
+{
+    // Coordinates and sizes of the supported displays fit into 16 bits
+    const auto v = static_cast<int16_t>(value);
+    const auto* const bytes = reinterpret_cast<const uint8_t*>(&v);
+
+    _data.insert(_data.end(), bytes, bytes + sizeof(v));
+}
+
+void DisplayList::addPointer(const void* const pointer)
+{
+    const auto* const bytes = reinterpret_cast<const uint8_t*>(&pointer);
+
+    _data.insert(_data.end(), bytes, bytes + sizeof(pointer));
+}
+
+void DisplayList::addText(const char* const text)
+{
+    const auto* const bytes = reinterpret_cast<const uint8_t*>(text);
+
+    _data.insert(_data.end(), bytes, bytes + std::strlen(text) + 1);
+}
+
+DisplayList::Reader::Reader(const DisplayList& list)
+    : _pos{ list._data.data() }
+    , _end{ list._data.data() + list._data.size() }
+{}
+
+bool DisplayList::Reader::atEnd() const
+{
+    return _pos >= _end;
+}
+
+DisplayList::Opcode DisplayList::Reader::readOpcode()
+{
+    return static_cast<Opcode>(*_pos++);
+}
+
+int DisplayList::Reader::readInt()
+{
+    int16_t v;
+    std::memcpy(&v, _pos, sizeof(v));
+    _pos += sizeof(v);
+
+    return v;
+}
+
+const void* DisplayList::Reader::readPointer()
+{
+    const void* pointer;
+    std::memcpy(&pointer, _pos, sizeof(pointer));
+    _pos += sizeof(pointer);
+
+    return pointer;
+}
+
+const char* DisplayList::Reader::readText()
+{
+    const auto* const text = reinterpret_cast<const char*>(_pos);
+    _pos += std::strlen(text) + 1;
+
+    return text;
+}
+
+}
@@ -23,27 +23,37 @@
 namespace U8W
 {
 
+Font::Font()
+{
+    updateMetrics();
+}
+
 Font::Font(
     Family family,
     Style style
 )
     : _family{ family }
     , _style{ style }
-{}
+{
+    updateMetrics();
+}
 
 void Font::setFamily(const Family family)
 {
     _family = family;
+    updateMetrics();
 }
 
 void Font::setStyle(const Style style)
 {
     _style = style;
+    updateMetrics();
 }
 
 void Font::setBold(const bool bold)
 {
     _bold = bold;
+    updateMetrics();
 }
 
 const uint8_t* Font::data() const
@@ -94,4 +104,27 @@ const uint8_t* Font::data() const
     return nullptr;
 }
 
+bool Font::isMonospace() const
+{
+    switch (_family) {
+        case Family::Pxl16x8_Mono:
+        case Family::Pxl16x8_Mono_x2:
+        case Family::BitCellMonoNumbers:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+const FontMetrics& Font::metrics() const
+{
+    return _metrics;
+}
+
+void Font::updateMetrics()
+{
+    _metrics = FontMetrics::fromData(data(), isMonospace());
+}
+
 }
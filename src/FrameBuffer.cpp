@@ -0,0 +1,309 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "FrameBuffer.h"
+
+#include "Utils.h"
+
+#include <array>
+#include <cstring>
+
+namespace U8W
+{
+
+namespace
+{
+
+constexpr std::array<uint8_t, 256> makeBitReverseTable()
+{
+    std::array<uint8_t, 256> table{};
+
+    for (auto i = 0; i < 256; ++i) {
+        uint8_t reversed = 0;
+
+        for (auto bit = 0; bit < 8; ++bit) {
+            if (i & (1 << bit)) {
+                reversed |= 0x80 >> bit;
+            }
+        }
+
+        table[i] = reversed;
+    }
+
+    return table;
+}
+
+constexpr auto bitReverseTable = makeBitReverseTable();
+
+void applyMask(uint8_t& b, const uint8_t mask, const int color)
+{
+    switch (color) {
+        case 0:
+            b &= ~mask;
+            break;
+        case 1:
+            b |= mask;
+            break;
+        default:
+            b ^= mask;
+            break;
+    }
+}
+
+void invertBytes(uint8_t* p, int count)
+{
+    while (count > 0 && (reinterpret_cast<uintptr_t>(p) & 3)) {
+        *p++ ^= 0xff;
+        --count;
+    }
+
+    // memcpy keeps the word accesses free of aliasing issues, it compiles
+    // to plain loads and stores
+    for (; count >= 4; count -= 4, p += 4) {
+        uint32_t word;
+        std::memcpy(&word, p, sizeof(word));
+        word = ~word;
+        std::memcpy(p, &word, sizeof(word));
+    }
+
+    while (count-- > 0) {
+        *p++ ^= 0xff;
+    }
+}
+
+void fillBytes(uint8_t* const p, const int count, const int color)
+{
+    if (color == 2) {
+        invertBytes(p, count);
+    } else {
+        std::memset(p, color ? 0xff : 0, count);
+    }
+}
+
+// Reads 32 pixels starting at an arbitrary pixel offset and returns
+// them MSB first. XBM data stores the leftmost pixel in the LSB.
+template <bool LsbFirst>
+uint32_t readBits(const uint8_t* const bits, const int offset, const int count)
+{
+    const auto* const p = bits + (offset >> 3);
+    const auto bytes = ((offset & 7) + count + 7) >> 3;
+
+    uint64_t value = 0;
+    for (auto i = 0; i < 5; ++i) {
+        value <<= 8;
+        if (i < bytes) {
+            value |= LsbFirst ? bitReverseTable[p[i]] : p[i];
+        }
+    }
+
+    return static_cast<uint32_t>(value >> (8 - (offset & 7)));
+}
+
+}
+
+FrameBuffer::FrameBuffer(
+    uint8_t* const data,
+    const int width,
+    const int height,
+    const int stride
+)
+    : _data{ data }
+    , _width{ width }
+    , _height{ height }
+    , _stride{ stride }
+{}
+
+bool FrameBuffer::isNull() const
+{
+    return !_data;
+}
+
+Rect FrameBuffer::rect() const
+{
+    return Rect{ 0, 0, _width, _height };
+}
+
+void FrameBuffer::drawBits(
+    const int x,
+    const int y,
+    const uint8_t* const bits,
+    const int width,
+    const int color,
+    const bool solid,
+    const Rect& clip
+)
+{
+    const auto area = clip & rect();
+
+    if (y < area.top() || y > area.bottom()) {
+        return;
+    }
+
+    drawRow<false>(x, y, bits, width, color, solid, area);
+}
+
+void FrameBuffer::drawXbm(
+    const int x,
+    const int y,
+    const int width,
+    const int height,
+    const uint8_t* const data,
+    const int color,
+    const bool solid,
+    const Rect& clip
+)
+{
+    const auto area = clip & rect();
+
+    if (area.isEmpty()) {
+        return;
+    }
+
+    const auto stride = (width + 7) / 8;
+    const auto y1 = Utils::max(y, area.top());
+    const auto y2 = Utils::min(y + height - 1, area.bottom());
+
+    for (auto row = y1; row <= y2; ++row) {
+        drawRow<true>(x, row, data + (row - y) * stride, width, color, solid, area);
+    }
+}
+
+void FrameBuffer::fillRect(const Rect& rect, const int color, const Rect& clip)
+{
+    const auto area = rect & clip & this->rect();
+
+    if (area.isEmpty()) {
+        return;
+    }
+
+    const auto x1 = area.left();
+    const auto x2 = area.right();
+    auto* row = _data + area.top() * _stride;
+
+    // Full rows are contiguous in the buffer
+    if (x1 == 0 && x2 == _width - 1 && _width == _stride * 8) {
+        fillBytes(row, area.height() * _stride, color);
+        return;
+    }
+
+    const auto first = x1 >> 3;
+    const auto last = x2 >> 3;
+    const auto leftMask = static_cast<uint8_t>(0xff >> (x1 & 7));
+    const auto rightMask = static_cast<uint8_t>(0xff << (7 - (x2 & 7)));
+
+    for (auto y = area.top(); y <= area.bottom(); ++y, row += _stride) {
+        if (first == last) {
+            applyMask(row[first], leftMask & rightMask, color);
+            continue;
+        }
+
+        applyMask(row[first], leftMask, color);
+        applyMask(row[last], rightMask, color);
+
+        const auto count = last - first - 1;
+
+        if (count > 0) {
+            fillBytes(row + first + 1, count, color);
+        }
+    }
+}
+
+void FrameBuffer::copyRect(const Rect& rect, uint8_t* data) const
+{
+    const auto stride = (rect.width() + 7) / 8;
+
+    for (auto y = rect.top(); y <= rect.bottom(); ++y, data += stride) {
+        const auto* const row = _data + y * _stride;
+
+        for (auto dx = 0; dx < rect.width(); dx += 32) {
+            const auto count = Utils::min(32, rect.width() - dx);
+            const auto mask = count == 32 ? ~0u : ~(~0u >> count);
+            const auto bits = readBits<false>(row, rect.left() + dx, count) & mask;
+            const auto bytes = (count + 7) / 8;
+
+            for (auto i = 0; i < bytes; ++i) {
+                data[dx / 8 + i] = static_cast<uint8_t>(bits >> (24 - i * 8));
+            }
+        }
+    }
+}
+
+template <bool LsbFirst>
+void FrameBuffer::drawRow(
+    const int x,
+    const int y,
+    const uint8_t* const bits,
+    const int width,
+    const int color,
+    const bool solid,
+    const Rect& area
+)
+{
+    const auto x1 = Utils::max(x, area.left());
+    const auto x2 = Utils::min(x + width - 1, area.right());
+
+    auto* const row = _data + y * _stride;
+
+    // Up to 32 pixels are processed at once, spanning at most 5 bytes
+    // of the destination row
+    for (auto dx = x1; dx <= x2; dx += 32) {
+        const auto count = Utils::min(32, x2 - dx + 1);
+        const auto mask32 = count == 32 ? ~0u : ~(~0u >> count);
+        const auto bits32 = readBits<LsbFirst>(bits, dx - x, count) & mask32;
+
+        const auto shift = dx & 7;
+        const auto mask = (static_cast<uint64_t>(mask32) << 8) >> shift;
+        const auto value = (static_cast<uint64_t>(bits32) << 8) >> shift;
+
+        auto* const p = row + (dx >> 3);
+        const auto bytes = (shift + count + 7) >> 3;
+
+        for (auto i = 0; i < bytes; ++i) {
+            const auto m = static_cast<uint8_t>(mask >> (32 - i * 8));
+            const auto v = static_cast<uint8_t>(value >> (32 - i * 8));
+            auto& b = p[i];
+
+            if (solid) {
+                // The background color is 0 for both 1 and XOR
+                switch (color) {
+                    case 0:
+                        b = (b & ~m) | (~v & m);
+                        break;
+                    case 1:
+                        b = (b & ~m) | v;
+                        break;
+                    default:
+                        b = (b & ~m) | (~b & v);
+                        break;
+                }
+            } else {
+                switch (color) {
+                    case 0:
+                        b &= ~v;
+                        break;
+                    case 1:
+                        b |= v;
+                        break;
+                    default:
+                        b ^= v;
+                        break;
+                }
+            }
+        }
+    }
+}
+
+}
@@ -0,0 +1,113 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "FrameScheduler.h"
+
+#include "Clock.h"
+#include "Display.h"
+#include "Painter.h"
+#include "Widget.h"
+
+namespace U8W
+{
+
+FrameScheduler::FrameScheduler(
+    Widget* const root,
+    Painter& painter,
+    Display& display,
+    Clock& clock
+)
+    : _root{ root }
+    , _painter{ painter }
+    , _display{ display }
+    , _clock{ clock }
+{}
+
+void FrameScheduler::setMaxFrameRate(const int framesPerSecond)
+{
+    _frameInterval = framesPerSecond > 0 ? 1'000'000 / framesPerSecond : 0;
+}
+
+void FrameScheduler::invalidate()
+{
+    _invalidated = true;
+}
+
+bool FrameScheduler::poll()
+{
+    if (!_invalidated && !_root->isRepaintPending()) {
+        return false;
+    }
+
+    if (timeUntilNextFrame() > 0) {
+        ++_statistics.deferredPolls;
+        return false;
+    }
+
+    const auto paintStart = _clock.microseconds();
+    const auto painted = _painter.renderWidget(_root);
+    const auto paintEnd = _clock.microseconds();
+
+    if (!painted && !_invalidated) {
+        return false;
+    }
+
+    _invalidated = false;
+
+    _display.update();
+
+    const auto transferEnd = _clock.microseconds();
+
+    _statistics.paintTime.add(static_cast<uint32_t>(paintEnd - paintStart));
+    _statistics.transferTime.add(static_cast<uint32_t>(transferEnd - paintEnd));
+    ++_statistics.frames;
+
+    const auto frameTime = transferEnd - paintStart;
+
+    if (_frameInterval > 0 && frameTime > _frameInterval) {
+        _statistics.droppedFrames += static_cast<uint32_t>((frameTime - 1) / _frameInterval);
+    }
+
+    _lastFrameStart = paintStart;
+    _hasRenderedFrame = true;
+
+    return true;
+}
+
+uint32_t FrameScheduler::timeUntilNextFrame() const
+{
+    if (!_hasRenderedFrame) {
+        return 0;
+    }
+
+    const auto elapsed = _clock.microseconds() - _lastFrameStart;
+
+    return elapsed >= _frameInterval
+        ? 0
+        : static_cast<uint32_t>(_frameInterval - elapsed);
+}
+
+const FrameScheduler::Statistics& FrameScheduler::statistics() const
+{
+    return _statistics;
+}
+
+void FrameScheduler::resetStatistics()
+{
+    _statistics = {};
+}
+
+}
@@ -0,0 +1,182 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "GlyphAtlas.h"
+
+#include "FontMetrics.h"
+
+#include <cstring>
+
+namespace U8W
+{
+
+void GlyphAtlas::setBudget(const size_t bytes)
+{
+    _sets = bytes / (sizeof(Slot) * Ways);
+
+    // Reallocates only here, lookups never allocate
+    _slots = std::vector<Slot>(_sets * Ways);
+    _useCounter = 0;
+}
+
+size_t GlyphAtlas::budget() const
+{
+    return _slots.size() * sizeof(Slot);
+}
+
+bool GlyphAtlas::isEnabled() const
+{
+    return _sets > 0;
+}
+
+void GlyphAtlas::clear()
+{
+    for (auto& slot : _slots) {
+        slot = Slot{};
+    }
+
+    _useCounter = 0;
+}
+
+const GlyphAtlas::Glyph* GlyphAtlas::find(const uint8_t* const font, const uint8_t encoding)
+{
+    if (_sets == 0 || !font) {
+        return nullptr;
+    }
+
+    const auto key = reinterpret_cast<uintptr_t>(font) ^ (encoding * 2654435761u);
+    auto* const set = &_slots[(key % _sets) * Ways];
+
+    auto* victim = set;
+
+    for (auto* slot = set; slot < set + Ways; ++slot) {
+        if (slot->font == font && slot->encoding == encoding) {
+            slot->lastUse = ++_useCounter;
+            ++_statistics.hits;
+            return &slot->glyph;
+        }
+
+        if (slot->lastUse < victim->lastUse) {
+            victim = slot;
+        }
+    }
+
+    Glyph glyph;
+
+    if (!decode(font, encoding, glyph)) {
+        ++_statistics.uncacheable;
+        return nullptr;
+    }
+
+    ++_statistics.misses;
+
+    if (victim->font) {
+        ++_statistics.evictions;
+    }
+
+    victim->font = font;
+    victim->encoding = encoding;
+    victim->lastUse = ++_useCounter;
+    victim->glyph = glyph;
+
+    return &victim->glyph;
+}
+
+const GlyphAtlas::Statistics& GlyphAtlas::statistics() const
+{
+    return _statistics;
+}
+
+void GlyphAtlas::resetStatistics()
+{
+    _statistics = {};
+}
+
+bool GlyphAtlas::decode(const uint8_t* const font, const uint8_t encoding, Glyph& glyph)
+{
+    glyph = Glyph{};
+
+    const auto* const data = FontMetrics::findGlyph(font, encoding);
+
+    // Missing glyphs are not drawn by u8g2 either
+    if (!data) {
+        return true;
+    }
+
+    FontMetrics::BitReader reader{ data + 2 };
+
+    const auto width = reader.readUnsigned(font[4]);
+    const auto height = reader.readUnsigned(font[5]);
+    const auto x = reader.readSigned(font[6]);
+    const auto y = reader.readSigned(font[7]);
+    const auto advance = reader.readSigned(font[8]);
+
+    const auto stride = (width + 7) / 8;
+
+    if (stride * height > MaxGlyphBytes) {
+        return false;
+    }
+
+    glyph.x = x;
+    glyph.y = -static_cast<int>(height) - y;
+    glyph.width = width;
+    glyph.height = height;
+    glyph.advance = advance;
+
+    if (width == 0) {
+        return true;
+    }
+
+    // Run-length decoding, as in u8g2_font_decode_glyph(): pairs of
+    // background and foreground run lengths, each pair repeated while
+    // the following bit is set
+    unsigned px = 0;
+    unsigned py = 0;
+
+    const auto fill = [&](unsigned length, const bool foreground) {
+        while (length > 0 && py < height) {
+            const auto run = length < width - px ? length : width - px;
+
+            if (foreground) {
+                for (auto i = px; i < px + run; ++i) {
+                    glyph.bits[py * stride + i / 8] |= 0x80 >> (i & 7);
+                }
+            }
+
+            px += run;
+            length -= run;
+
+            if (px == width) {
+                px = 0;
+                ++py;
+            }
+        }
+    };
+
+    while (py < height) {
+        const auto zeros = reader.readUnsigned(font[2]);
+        const auto ones = reader.readUnsigned(font[3]);
+
+        do {
+            fill(zeros, false);
+            fill(ones, true);
+        } while (reader.readUnsigned(1) != 0);
+    }
+
+    return true;
+}
+
+}
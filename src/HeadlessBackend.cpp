@@ -0,0 +1,119 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "HeadlessBackend.h"
+
+namespace U8W
+{
+
+namespace
+{
+
+const u8x8_display_info_t headlessDisplayInfo = {
+    /* chip_enable_level = */ 0,
+    /* chip_disable_level = */ 1,
+    /* post_chip_enable_wait_ns = */ 0,
+    /* pre_chip_disable_wait_ns = */ 0,
+    /* reset_pulse_width_ms = */ 0,
+    /* post_reset_wait_ms = */ 0,
+    /* sda_setup_time_ns = */ 0,
+    /* sck_pulse_width_ns = */ 0,
+    /* sck_clock_hz = */ 60'000'000UL,
+    /* spi_mode = */ 0,
+    /* i2c_bus_clock_100kHz = */ 0,
+    /* data_setup_time_ns = */ 0,
+    /* write_pulse_width_ns = */ 0,
+    /* tile_width = */ 30,
+    /* tile_height = */ 20,
+    /* default_x_offset = */ 0,
+    /* flipmode_x_offset = */ 0,
+    /* pixel_width = */ 240,
+    /* pixel_height = */ 160
+};
+
+}
+
+extern "C" uint8_t u8x8_d_headless_240x160(
+    u8x8_t* const u8x8,
+    const uint8_t msg,
+    uint8_t arg_int,
+    void* const arg_ptr
+)
+{
+    switch (msg)
+    {
+        case U8X8_MSG_DISPLAY_SETUP_MEMORY:
+            u8x8_d_helper_display_setup_memory(u8x8, &headlessDisplayInfo);
+            break;
+
+        case U8X8_MSG_DISPLAY_INIT:
+            u8x8_d_helper_display_init(u8x8);
+            break;
+
+        case U8X8_MSG_DISPLAY_DRAW_TILE: {
+            // The tile data is sent as is, so the transport sees the
+            // same amount of traffic as a 1bpp panel would
+            auto* const tile = static_cast<u8x8_tile_t*>(arg_ptr);
+
+            u8x8_cad_StartTransfer(u8x8);
+
+            do {
+                u8x8_cad_SendData(u8x8, tile->cnt * 8, tile->tile_ptr);
+            } while (--arg_int > 0);
+
+            u8x8_cad_EndTransfer(u8x8);
+            break;
+        }
+
+        case U8X8_MSG_DISPLAY_SET_POWER_SAVE:
+        case U8X8_MSG_DISPLAY_SET_CONTRAST:
+        case U8X8_MSG_DISPLAY_SET_FLIP_MODE:
+        case U8X8_MSG_DISPLAY_REFRESH:
+            break;
+
+        default:
+            return 0;
+    }
+
+    return 1;
+}
+
+HeadlessBackend::HeadlessBackend(Transport* const transport)
+    : _transport{ transport ? transport : &_countingTransport }
+{}
+
+void HeadlessBackend::setupDisplay(u8g2_t* const u8g2, const u8x8_msg_cb byteCallback)
+{
+    u8g2_SetupDisplay(
+        u8g2,
+        u8x8_d_headless_240x160,
+        u8x8_cad_001,
+        byteCallback,
+        u8x8_dummy_cb
+    );
+}
+
+Transport& HeadlessBackend::transport()
+{
+    return *_transport;
+}
+
+const CountingTransport::Statistics& HeadlessBackend::transportStatistics() const
+{
+    return _countingTransport.statistics();
+}
+
+}
@@ -54,7 +54,7 @@ void Image::setImage(
 void Image::setInverted(const bool inverted)
 {
     _inverted = inverted;
-    _needsRepaint = true;
+    requestRepaint();
 }
 
 Size Image::imageSize() const
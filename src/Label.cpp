@@ -17,6 +17,9 @@
 #include "Label.h"
 
 #include "Display.h"
+#include "Utils.h"
+
+#include <cstring>
 
 namespace U8W
 {
@@ -27,17 +30,45 @@ Label::Label(Widget* parent)
     updateHeightByFont();
 }
 
-Label::Label(std::string text, Widget* parent)
+Label::Label(const std::string_view text, Widget* parent)
     : Widget{ parent }
-    , _text{ std::move(text) }
 {
+    storeText(text);
     updateHeightByFont();
 }
 
-void Label::setText(std::string text)
+void Label::setText(const std::string_view text)
 {
-    _text = std::move(text);
-    updateTextPosition();
+    if (_incrementalRedraw && updateChangedGlyphCells(text)) {
+        return;
+    }
+
+    if (storeText(text)) {
+        updateTextPosition();
+    }
+}
+
+std::string_view Label::text() const
+{
+    return std::string_view{ _text, _textLength };
+}
+
+void Label::setNumber(const int32_t value, const NumberFormat& format)
+{
+    char text[MaxTextLength + 1];
+    const auto length = formatNumber(text, sizeof(text), value, format);
+    setText(std::string_view{ text, length });
+}
+
+void Label::setFixedPoint(
+    const int32_t value,
+    const uint8_t decimals,
+    const NumberFormat& format
+)
+{
+    char text[MaxTextLength + 1];
+    const auto length = formatFixedPoint(text, sizeof(text), value, decimals, format);
+    setText(std::string_view{ text, length });
 }
 
 void Label::setFont(const Font& font)
@@ -47,6 +78,11 @@ void Label::setFont(const Font& font)
     updateTextPosition();
 }
 
+void Label::setIncrementalRedrawEnabled(const bool enabled)
+{
+    _incrementalRedraw = enabled;
+}
+
 void Label::setAlignment(const Align alignment)
 {
     _alignment = alignment;
@@ -65,65 +101,127 @@ void Label::paint()
     _display->setFont(_font);
     // _display->setClipRect(calculateClipRect());
 
-    _display->drawText(_textPos, _text);
+    _display->drawText(mapToGlobal(_rect.topLeft()) + _textPos, _text);
 
     // _display->resetClipRect();
 
     Widget::paint();
 }
 
+bool Label::storeText(const std::string_view text)
+{
+    const auto length = Utils::min(text.size(), MaxTextLength);
+
+    if (length == _textLength && std::memcmp(_text, text.data(), length) == 0) {
+        return false;
+    }
+
+    std::memcpy(_text, text.data(), length);
+    _text[length] = '\0';
+    _textLength = length;
+
+    return true;
+}
+
+bool Label::updateChangedGlyphCells(const std::string_view text)
+{
+    const auto& metrics = _font.metrics();
+    const auto length = Utils::min(text.size(), MaxTextLength);
+
+    // The text keeps its position only if its width is unchanged
+    if (!metrics.isMonospace() || length != _textLength) {
+        return false;
+    }
+
+    size_t first = 0;
+
+    while (first < length && _text[first] == text[first]) {
+        ++first;
+    }
+
+    if (first == length) {
+        return true;
+    }
+
+    auto last = length - 1;
+
+    while (_text[last] == text[last]) {
+        --last;
+    }
+
+    storeText(text);
+
+    // The old and the new glyphs may reach into the neighbouring cells,
+    // the area is limited to the label as that clips the text anyway
+    const auto span = metrics.monospaceCellSpan(_textPos.x(), first, last + 1);
+    const auto left = Utils::max(0, span.left);
+    const auto right = Utils::min(_rect.width(), span.right);
+
+    if (left < right) {
+        requestRepaint(Rect{ left, 0, right - left, _rect.height() });
+    }
+
+    return true;
+}
+
 void Label::updateHeightByFont()
 {
-    _needsRepaint = true;
-    _display->setFont(_font);
+    requestRepaint();
+
+    const auto& metrics = _font.metrics();
 
     switch (_heightCalculation) {
         case HeightCalculation::NoDescent:
-            setHeight(_display->calculateFontAscent());
+            setHeight(metrics.ascent);
             break;
 
         case HeightCalculation::WithDescent:
-            setHeight(_display->calculateMaxCharHeight() + 1);
+            setHeight(metrics.maxCharHeight + 1);
             break;
     }
 }
 
+int Label::calculateTextWidth() const
+{
+    const auto& metrics = _font.metrics();
+
+    if (metrics.isMonospace()) {
+        return metrics.monospaceTextWidth(_textLength);
+    }
+
+    _display->setFont(_font);
+    return _display->calculateTextWidth(_text);
+}
+
 void Label::updateTextPosition()
 {
-    _needsRepaint = true;
+    requestRepaint();
+
+    const auto ascent = _font.metrics().ascent;
 
     switch (_alignment) {
         case Align::Left:
-            _display->setFont(_font);
-            _textPos = 
-                mapToGlobal(_rect.topLeft())
-                + Point{
-                    0,
-                    _display->calculateFontAscent() + 1
-                };
+            _textPos = Point{
+                0,
+                ascent + 1
+            };
             break;
 
         case Align::Center: {
-            _display->setFont(_font);
-            const auto textWidth = _display->calculateTextWidth(_text);
-            _textPos =
-                mapToGlobal(_rect.topLeft())
-                + Point{
-                    _rect.width() / 2 - textWidth / 2,
-                    _display->calculateFontAscent() + 1
-                };
+            const auto textWidth = calculateTextWidth();
+            _textPos = Point{
+                _rect.width() / 2 - textWidth / 2,
+                ascent + 1
+            };
             break;
         }
 
         case Align::Right: {
-            _display->setFont(_font);
-            const auto textWidth = _display->calculateTextWidth(_text);
-            _textPos =
-                mapToGlobal(_rect.topLeft())
-                + Point{
-                    _rect.width() - textWidth,
-                    _display->calculateFontAscent() + 1
-                };
+            const auto textWidth = calculateTextWidth();
+            _textPos = Point{
+                _rect.width() - textWidth,
+                ascent + 1
+            };
             break;
         }
     }
@@ -0,0 +1,133 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "LatencyTracer.h"
+
+#include "Clock.h"
+#include "Utils.h"
+
+#include <cstring>
+
+namespace U8W
+{
+
+LatencyTracer::LatencyTracer(Clock& clock)
+    : _clock{ clock }
+{}
+
+uint64_t LatencyTracer::now() const
+{
+    return _clock.microseconds();
+}
+
+void LatencyTracer::widgetPainted(const char* const name, const uint64_t invalidatedAt)
+{
+    const auto widget = findOrAddWidget(name);
+
+    if (widget < 0 || _pending.count == MaxPaintsPerFrame) {
+        ++_droppedSamples;
+        return;
+    }
+
+    _pending.paints[_pending.count++] = Paint{
+        static_cast<uint8_t>(widget),
+        invalidatedAt
+    };
+}
+
+void LatencyTracer::frameSubmitted()
+{
+    _droppedSamples += _inFlight.count;
+    _inFlight = _pending;
+    _pending.count = 0;
+}
+
+void LatencyTracer::frameTransferred()
+{
+    if (_inFlight.count == 0) {
+        return;
+    }
+
+    const auto end = now();
+    uint32_t frameLatency = 0;
+
+    for (size_t i = 0; i < _inFlight.count; ++i) {
+        const auto& paint = _inFlight.paints[i];
+        const auto latency = static_cast<uint32_t>(end - paint.invalidatedAt);
+
+        _widgets[paint.widget].latency.add(latency);
+        frameLatency = Utils::max(frameLatency, latency);
+    }
+
+    _frameLatency.add(frameLatency);
+    _inFlight.count = 0;
+}
+
+void LatencyTracer::frameSkipped()
+{
+    _pending.count = 0;
+}
+
+size_t LatencyTracer::widgetCount() const
+{
+    return _widgetCount;
+}
+
+const LatencyTracer::WidgetLatency& LatencyTracer::widget(const size_t index) const
+{
+    return _widgets[index];
+}
+
+const TimingWindow& LatencyTracer::frameLatency() const
+{
+    return _frameLatency;
+}
+
+uint32_t LatencyTracer::droppedSamples() const
+{
+    return _droppedSamples;
+}
+
+void LatencyTracer::reset()
+{
+    _widgetCount = 0;
+    _pending.count = 0;
+    _inFlight.count = 0;
+    _frameLatency.reset();
+    _droppedSamples = 0;
+}
+
+int LatencyTracer::findOrAddWidget(const char* const name)
+{
+    for (size_t i = 0; i < _widgetCount; ++i) {
+        if (std::strncmp(_widgets[i].name, name, MaxNameLength) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+
+    if (_widgetCount == MaxWidgets) {
+        return -1;
+    }
+
+    auto& widget = _widgets[_widgetCount];
+    std::strncpy(widget.name, name, MaxNameLength);
+    widget.name[MaxNameLength] = '\0';
+    widget.latency.reset();
+
+    return static_cast<int>(_widgetCount++);
+}
+
+}
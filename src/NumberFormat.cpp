@@ -0,0 +1,138 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+#include "NumberFormat.h"
+
+namespace U8W
+{
+
+namespace
+{
+
+class Writer
+{
+public:
+    Writer(char* const buffer, const size_t capacity)
+        : _buffer{ buffer }
+        , _capacity{ capacity }
+    {}
+
+    void put(const char c)
+    {
+        // One byte is kept for the terminator
+        if (_length + 1 < _capacity) {
+            _buffer[_length++] = c;
+        }
+    }
+
+    size_t finish()
+    {
+        if (_capacity > 0) {
+            _buffer[_length] = '\0';
+        }
+
+        return _length;
+    }
+
+private:
+    char* const _buffer;
+    const size_t _capacity;
+    size_t _length = 0;
+};
+
+}
+
+size_t formatNumber(
+    char* const buffer,
+    const size_t capacity,
+    const int32_t value,
+    const NumberFormat& format
+)
+{
+    return formatFixedPoint(buffer, capacity, value, 0, format);
+}
+
+size_t formatFixedPoint(
+    char* const buffer,
+    const size_t capacity,
+    const int32_t value,
+    uint8_t decimals,
+    const NumberFormat& format
+)
+{
+    if (decimals > 9) {
+        decimals = 9;
+    }
+
+    const auto negative = value < 0;
+    auto magnitude = negative
+        ? 0u - static_cast<uint32_t>(value)
+        : static_cast<uint32_t>(value);
+
+    // Digits in reverse order, the integer part has at least one digit
+    char digits[12];
+    size_t count = 0;
+
+    for (auto i = 0; i < decimals; ++i) {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    }
+
+    if (decimals > 0) {
+        digits[count++] = '.';
+    }
+
+    do {
+        digits[count++] = static_cast<char>('0' + magnitude % 10);
+        magnitude /= 10;
+    } while (magnitude > 0);
+
+    const auto length = count + (negative ? 1 : 0);
+    const auto padding = format.width > length ? format.width - length : 0;
+
+    Writer writer{ buffer, capacity };
+
+    if (format.padding != '0') {
+        for (size_t i = 0; i < padding; ++i) {
+            writer.put(format.padding);
+        }
+    }
+
+    if (negative) {
+        writer.put('-');
+    }
+
+    if (format.padding == '0') {
+        for (size_t i = 0; i < padding; ++i) {
+            writer.put('0');
+        }
+    }
+
+    while (count > 0) {
+        writer.put(digits[--count]);
+    }
+
+    if (format.suffix) {
+        for (const auto* p = format.suffix; *p; ++p) {
+            writer.put(*p);
+        }
+    }
+
+    return writer.finish();
+}
+
+}
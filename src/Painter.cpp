@@ -16,7 +16,9 @@
 
 #include "Painter.h"
 
+#include "Clock.h"
 #include "Display.h"
+#include "DisplayList.h"
 #include "Widget.h"
 
 #include <iostream>
@@ -30,87 +32,605 @@ namespace U8W
 Painter::Painter()
 {}
 
+void Painter::setRepaintMode(const RepaintMode mode)
+{
+    // Full repaints don't keep the damage rectangles up to date
+    if (mode == RepaintMode::Damage && _repaintMode != mode) {
+        _damageRectsOutdated = true;
+    }
+
+    _repaintMode = mode;
+}
+
+void Painter::setOcclusionCullingEnabled(const bool enabled)
+{
+    _occlusionCullingEnabled = enabled;
+}
+
+const Painter::Statistics& Painter::statistics() const
+{
+    return _statistics;
+}
+
+void Painter::resetStatistics()
+{
+    _statistics = {};
+}
+
+void Painter::setBitmapCacheBudget(const size_t bytes)
+{
+    _bitmapCache.setBudget(bytes);
+}
+
+const BitmapCache::Statistics& Painter::bitmapCacheStatistics() const
+{
+    return _bitmapCache.statistics();
+}
+
+void Painter::resetBitmapCacheStatistics()
+{
+    _bitmapCache.resetStatistics();
+}
+
+void Painter::setRenderProfiler(RenderProfiler* const profiler)
+{
+    _profiler = profiler;
+}
+
 void Painter::paintWidget(Widget* const widget)
 {
 #if DEBUG_PAINTER
-    std::cout << __FUNCTION__ << ": widget=" << widget->_name << '\n';
+    std::cout << __FUNCTION__ << ": widget=" << widget->name() << '\n';
 #endif
 
-    updateWidgetRepaintFlags(widget);
-
-    const auto needsDisplayUpdate = paintWidgetRecursive(widget);
+    const auto needsDisplayUpdate = renderWidget(widget);
 
     if (needsDisplayUpdate) {
 #if DEBUG_PAINTER
-        std::cout << __FUNCTION__ << ": updating display, widget=" << widget->_name << '\n';
+        std::cout << __FUNCTION__ << ": updating display, widget=" << widget->name() << '\n';
 #endif
         widget->_display->update();
     }
+}
+
+bool Painter::renderWidget(Widget* const widget)
+{
+#if U8W_RENDER_PROFILING
+    if (_profiler) {
+        _profiler->beginFrame();
+    }
+#endif
+
+    const auto painted =
+        _repaintMode == RepaintMode::Damage
+            ? paintDamage(widget)
+            : paintFull(widget);
 
     widget->_display->resetClipRect();
+
+    return painted;
+}
+
+Rect Painter::visibleRect(const Widget* const w)
+{
+    return w->calculateClipRect() & Rect{ Point{}, w->_display->size() };
+}
+
+Rect Painter::repaintRect(const Widget* const w, const Rect& clipRect)
+{
+    if (!w->_partialRepaint) {
+        return clipRect;
+    }
+
+    const auto& area = w->_repaintArea;
+
+    return clipRect & w->mapToGlobal(Rect{ w->_rect.topLeft() + area.topLeft(), area.size() });
+}
+
+void Painter::clearRepaintRequest(Widget* const w)
+{
+    w->_needsRepaint = false;
+    w->_partialRepaint = false;
+    w->_repaintArea = Rect{};
+}
+
+bool Painter::paintFull(Widget* const root)
+{
+    _repaintList.clear();
+#if U8W_RENDER_PROFILING
+    _repaintReasons.clear();
+#endif
+    scheduleRepaints(root, false);
+
+    if (_occlusionCullingEnabled) {
+        cullOccludedWidgets(root);
+    }
+
+    auto needsDisplayUpdate = false;
+
+    for (size_t i = 0; i < _repaintList.size(); ++i) {
+        auto* const w = _repaintList[i];
+
+        // Cleared for the occluded widgets
+        if (w->_needsRepaint) {
+            const auto clipRect = visibleRect(w);
+            const auto paintRect = repaintRect(w, clipRect);
+
+            // Cleared before painting, so a request made while painting
+            // is kept for the next frame
+            clearRepaintRequest(w);
+
+#if U8W_RENDER_PROFILING
+            const auto reason = _repaintReasons[i];
+#else
+            const auto reason = RenderProfiler::Reason::Self;
+#endif
+
+            if (const auto* const bits = findCachedBitmap(w, clipRect)) {
+                drawCachedBitmap(w, clipRect, clipRect, bits);
+
+                if (w->_cacheMode == Widget::CacheMode::BitmapWithChildren) {
+                    i = skipDescendants(i);
+                }
+            } else {
+                paintWidgetBackgroundAndContent(w, paintRect, reason);
+
+                // Only completely repainted widgets can be captured
+                if (paintRect == clipRect && isCacheable(w)) {
+                    if (w->_cacheMode == Widget::CacheMode::Bitmap) {
+                        captureBitmap(w, clipRect);
+                    } else {
+                        _pendingCaptures.push_back(w);
+                    }
+                }
+            }
+
+            needsDisplayUpdate = true;
+        } else {
+            // Occluded, its pixels are stale until the occluder moves.
+            // The pending captures are all ancestors of it, a bitmap of
+            // theirs would keep the stale pixels.
+            _pendingCaptures.clear();
+        }
+
+        // Subtree bitmaps are captured once the whole subtree is painted,
+        // descendants follow their ancestor in the list
+        while (
+            !_pendingCaptures.empty()
+            && (
+                i + 1 == _repaintList.size()
+                || !isAncestor(_pendingCaptures.back(), _repaintList[i + 1])
+            )
+        ) {
+            auto* const cached = _pendingCaptures.back();
+            _pendingCaptures.pop_back();
+
+            captureBitmap(cached, visibleRect(cached));
+        }
+    }
+
+    return needsDisplayUpdate;
 }
 
-void Painter::updateWidgetRepaintFlags(Widget* const w)
+bool Painter::paintDamage(Widget* const root)
 {
+    Region damage;
+
+    _repaintList.clear();
+
+    // Widgets may have moved since their damage rectangle was stored,
+    // the whole tree is repainted once and the rectangles refreshed
+    if (_damageRectsOutdated) {
+        _damageRectsOutdated = false;
+
+        collectDamage(root, damage, true);
+        damage |= Region{ visibleRect(root) };
+    } else {
+        collectDamage(root, damage, false);
+    }
+
+    if (_occlusionCullingEnabled) {
+        cullOccludedWidgets(root);
+    }
+
+    for (auto* w : _repaintList) {
+        if (w->_needsRepaint) {
+            damage |= Region{ repaintRect(w, visibleRect(w)) };
+            clearRepaintRequest(w);
+        }
+    }
+
+    if (damage.isEmpty()) {
+        return false;
+    }
+
 #if DEBUG_PAINTER
-    std::cout << __FUNCTION__ << ": widget=" << w->_name << '\n';
+    std::cout << __FUNCTION__
+        << ": damage=" << damage.boundingRect()
+        << ", rects=" << damage.rects().size()
+        << '\n';
+#endif
+
+    paintDamageRecursive(root, damage);
+
+    return true;
+}
+
+void Painter::paintWidgetBackgroundAndContent(
+    Widget* const w,
+    const Rect& clipRect,
+    [[maybe_unused]] const RenderProfiler::Reason reason
+)
+{
+#if U8W_RENDER_PROFILING
+    uint64_t start = 0;
+    uint32_t drawCalls = 0;
+
+    if (_profiler) {
+        start = _profiler->clock().microseconds();
+        drawCalls = w->_display->drawStatistics().drawCalls;
+    }
 #endif
 
-    // Repaint parent if its child requests it (e.g geometry change)
-    for (auto* child : w->_children) {
+    w->_display->setClipRect(clipRect);
+
+    // Clear the background
+    if (w->_backgroundEnabled) {
+        w->_display->setDrawColor(Display::Color::White);
+        w->_display->fillRect(clipRect);
+    }
+
 #if DEBUG_PAINTER
-        std::cout << __FUNCTION__ << ": widget=" << w->_name << '\n';
+    std::cout << __FUNCTION__ <<
+        ": painting, widget=" << w->name()
+        << ", rect=" << w->_rect
+        << ", clipRect=" << clipRect
+        << ", backgroundEnabled=" << w->_backgroundEnabled
+        << '\n';
+#endif
+
+    paintContent(w);
+
+    ++_statistics.paints;
+
+#if U8W_LATENCY_TRACING
+    if (w->_invalidationTraced) {
+        w->_invalidationTraced = false;
+
+        if (auto* tracer = w->_display->latencyTracer()) {
+            tracer->widgetPainted(w->name(), w->_invalidatedAt);
+        }
+    }
 #endif
-        w->_needsRepaint |= child->_parentNeedsRepaint;
-        child->_parentNeedsRepaint = false;
+
+#if U8W_RENDER_PROFILING
+    if (_profiler) {
+        _profiler->record(
+            w->name(),
+            reason,
+            static_cast<uint32_t>(_profiler->clock().microseconds() - start),
+            w->_backgroundEnabled ? clipRect.width() * clipRect.height() : 0,
+            w->_display->drawStatistics().drawCalls - drawCalls
+        );
     }
+#endif
+}
 
-    // Children must be repainted if parent is repainted
-    for (auto* child : w->_children) {
-        child->_needsRepaint |= w->_needsRepaint;
-        updateWidgetRepaintFlags(child);
+void Painter::paintContent(Widget* const w)
+{
+    auto* const list = w->_displayList.get();
+
+    if (!list) {
+        w->paint();
+        return;
+    }
+
+    if (w->_displayListValid) {
+        w->_display->replay(*list);
+        ++_statistics.replays;
+        return;
     }
+
+    list->clear();
+
+    w->_display->beginRecording(list);
+    w->paint();
+    w->_display->endRecording();
+
+    w->_displayListValid = true;
 }
 
-bool Painter::paintWidgetRecursive(Widget* const w)
+void Painter::scheduleRepaints(Widget* const w, const bool parentRepainted)
 {
+    // Nothing to do in clean subtrees
+    if (!parentRepainted && !w->_needsRepaint && !w->_descendantNeedsRepaint) {
+        return;
+    }
+
 #if DEBUG_PAINTER
-    std::cout << __FUNCTION__ << ": widget=" << w->_name << '\n';
+    std::cout << __FUNCTION__ << ": widget=" << w->name() << '\n';
 #endif
 
-    auto needsDisplayUpdate = false;
+    // Hidden and clipped out widgets keep their flags, they are
+    // repainted together with their parent when they are shown or moved
+    // into view
+    if (!w->_visible || visibleRect(w).isEmpty()) {
+        return;
+    }
 
-    if (w->_needsRepaint) {
-        const auto clipRect = w->calculateClipRect();
-        w->_display->setClipRect(clipRect);
+#if U8W_RENDER_PROFILING
+    auto reason = w->_needsRepaint
+        ? RenderProfiler::Reason::Self
+        : RenderProfiler::Reason::Parent;
+#endif
 
-        // Clear the background
-        if (w->_backgroundEnabled) {
-            w->_display->setDrawColor(Display::Color::White);
-            w->_display->fillRect(clipRect);
+    // Repaint parent if its child requests it (e.g geometry change).
+    // Such a child is dirty itself, so it is only looked for on dirty
+    // paths.
+    if (w->_descendantNeedsRepaint) {
+        for (auto* child = w->_firstChild; child; child = child->_nextSibling) {
+#if U8W_RENDER_PROFILING
+            if (!w->_needsRepaint && child->_parentNeedsRepaint) {
+                reason = RenderProfiler::Reason::Child;
+            }
+#endif
+            if (child->_parentNeedsRepaint) {
+                w->_needsRepaint = true;
+                w->_partialRepaint = false;
+            }
+            child->_parentNeedsRepaint = false;
         }
+    }
 
-#if DEBUG_PAINTER
-        std::cout << __FUNCTION__ <<
-            ": painting, widget=" << w->_name
-            << ", rect=" << w->_rect
-            << ", clipRect=" << clipRect
-            << ", backgroundEnabled=" << w->_backgroundEnabled
-            << '\n';
+    // Children must be repainted if parent is repainted
+    if (parentRepainted) {
+        w->_needsRepaint = true;
+        w->_partialRepaint = false;
+    }
+    w->_descendantNeedsRepaint = false;
+
+    if (w->_needsRepaint) {
+        _repaintList.push_back(w);
+#if U8W_RENDER_PROFILING
+        _repaintReasons.push_back(reason);
 #endif
+    }
 
-        w->paint();
+    for (auto* child = w->_firstChild; child; child = child->_nextSibling) {
+        scheduleRepaints(child, w->_needsRepaint);
+    }
+}
 
-        w->_needsRepaint = false;
+void Painter::collectDamage(Widget* const w, Region& damage, bool geometryChanged)
+{
+    // The clip rectangles in a subtree can only change with the geometry
+    // of the subtree's root
+    geometryChanged |= w->_parentNeedsRepaint;
 
-        needsDisplayUpdate = true;
+    if (!geometryChanged && !w->_needsRepaint && !w->_descendantNeedsRepaint) {
+        return;
     }
 
-    for (auto* child : w->_children) {
-        needsDisplayUpdate |= paintWidgetRecursive(child);
+    const auto clipRect = w->_visible ? visibleRect(w) : Rect{};
+
+    // Geometry changes expose the area the widget covered before
+    if (w->_parentNeedsRepaint) {
+        damage |= Region{ w->_damageRect };
     }
 
-    return needsDisplayUpdate;
+    w->_damageRect = clipRect;
+    w->_parentNeedsRepaint = false;
+
+    // Hidden and clipped out widgets keep their flags, the area of their
+    // parent is damaged when they are shown or moved into view
+    if (!w->_visible || (clipRect.isEmpty() && !geometryChanged)) {
+        return;
+    }
+
+    // The current area is added after occlusion culling
+    if (w->_needsRepaint && !clipRect.isEmpty()) {
+        _repaintList.push_back(w);
+    }
+
+    w->_descendantNeedsRepaint = false;
+
+    for (auto* child = w->_firstChild; child; child = child->_nextSibling) {
+        collectDamage(child, damage, geometryChanged);
+    }
+}
+
+void Painter::paintDamageRecursive(Widget* const w, const Region& damage)
+{
+    if (!w->_visible) {
+        return;
+    }
+
+    const auto clipRect = visibleRect(w);
+
+    // Children are clipped to their ancestors, so they can't be damaged
+    // either
+    if (!damage.intersects(clipRect)) {
+        return;
+    }
+
+    // The display clips to a single rectangle, so the widget is painted
+    // once for each damaged part of it
+    const auto area = damage & Region{ clipRect };
+    const auto* const bits = findCachedBitmap(w, clipRect);
+
+    for (const auto& rect : area.rects()) {
+        if (bits) {
+            drawCachedBitmap(w, rect, clipRect, bits);
+        } else {
+            paintWidgetBackgroundAndContent(w, rect, RenderProfiler::Reason::Damage);
+        }
+    }
+
+    if (bits && w->_cacheMode == Widget::CacheMode::BitmapWithChildren) {
+        return;
+    }
+
+    // Only completely repainted widgets can be captured
+    const auto capture =
+        !bits
+        && isCacheable(w)
+        && area.rects().size() == 1
+        && area.rects().front() == clipRect;
+
+    if (capture && w->_cacheMode == Widget::CacheMode::Bitmap) {
+        captureBitmap(w, clipRect);
+    }
+
+    for (auto* child = w->_firstChild; child; child = child->_nextSibling) {
+        paintDamageRecursive(child, damage);
+    }
+
+    if (capture && w->_cacheMode == Widget::CacheMode::BitmapWithChildren) {
+        captureBitmap(w, clipRect);
+    }
+}
+
+bool Painter::isCacheable(const Widget* const w) const
+{
+    // The bitmap of a transparent widget would contain what is below it
+    return
+        w->_cacheMode != Widget::CacheMode::None
+        && w->_backgroundEnabled
+        && _bitmapCache.isEnabled();
+}
+
+bool Painter::isAncestor(const Widget* const ancestor, const Widget* w)
+{
+    for (w = w->_parent; w; w = w->_parent) {
+        if (w == ancestor) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+size_t Painter::skipDescendants(size_t index)
+{
+    const auto* const w = _repaintList[index];
+
+    while (index + 1 < _repaintList.size() && isAncestor(w, _repaintList[index + 1])) {
+        clearRepaintRequest(_repaintList[++index]);
+    }
+
+    return index;
+}
+
+const uint8_t* Painter::findCachedBitmap(const Widget* const w, const Rect& clipRect)
+{
+    if (!isCacheable(w)) {
+        return nullptr;
+    }
+
+    // The outdated bitmap is missed, its buffer is reused by the next
+    // capture
+    if (!w->_bitmapCacheValid) {
+        _bitmapCache.invalidate(w->_cacheKey);
+    }
+
+    return _bitmapCache.find(w->_cacheKey, clipRect);
+}
+
+void Painter::drawCachedBitmap(
+    Widget* const w,
+    const Rect& rect,
+    const Rect& bitmapRect,
+    const uint8_t* const bits
+)
+{
+    w->_display->setClipRect(rect);
+    w->_display->writePixels(bitmapRect, bits);
+}
+
+void Painter::captureBitmap(Widget* const w, const Rect& clipRect)
+{
+    auto* const bits = _bitmapCache.insert(w->_cacheKey, clipRect);
+
+    w->_bitmapCacheValid = bits && w->_display->readPixels(clipRect, bits);
+
+    if (bits && !w->_bitmapCacheValid) {
+        _bitmapCache.remove(w->_cacheKey);
+    }
+}
+
+void Painter::cullOccludedWidgets(Widget* const root)
+{
+    if (_repaintList.empty()) {
+        return;
+    }
+
+    // Only the opaque areas over the scheduled widgets are of interest
+    Rect bounds;
+
+    for (const auto* w : _repaintList) {
+        bounds |= repaintRect(w, visibleRect(w));
+    }
+
+    Region cover;
+    auto remaining = _repaintList.size();
+
+    cullOccludedWidgetsRecursive(root, bounds, cover, remaining);
+}
+
+bool Painter::cullOccludedWidgetsRecursive(
+    Widget* const w,
+    const Rect& bounds,
+    Region& cover,
+    size_t& remaining
+)
+{
+    if (!w->_visible) {
+        return false;
+    }
+
+    const auto clipRect = visibleRect(w);
+
+    // Children are clipped to their ancestors, so the whole subtree is
+    // outside of the bounds
+    if ((clipRect & bounds).isEmpty()) {
+        return false;
+    }
+
+    // Visit the widgets in reverse painting order, the cover is the area
+    // painted over by the opaque widgets visited so far
+    for (auto* child = w->_lastChild; child; child = child->_previousSibling) {
+        if (cullOccludedWidgetsRecursive(child, bounds, cover, remaining)) {
+            return true;
+        }
+    }
+
+    if (w->_needsRepaint) {
+        if ((Region{ repaintRect(w, clipRect) } - cover).isEmpty()) {
+            clearRepaintRequest(w);
+            ++_statistics.culledPaints;
+
+#if U8W_LATENCY_TRACING
+            // Nothing of it will reach the display
+            w->_invalidationTraced = false;
+#endif
+
+#if DEBUG_PAINTER
+            std::cout << __FUNCTION__ << ": occluded, widget=" << w->name() << '\n';
+#endif
+        }
+
+        // Widgets painted earlier than the first scheduled one don't
+        // matter
+        if (--remaining == 0) {
+            return true;
+        }
+    }
+
+    if (w->_backgroundEnabled) {
+        cover |= Region{ clipRect & bounds };
+    }
+
+    return false;
 }
 
 }
@@ -0,0 +1,259 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "PicoSpiTransport.h"
+
+#include <hardware/dma.h>
+#include <hardware/gpio.h>
+#include <hardware/irq.h>
+#include <hardware/spi.h>
+
+#include <pico.h>
+
+namespace U8W
+{
+
+namespace Pins::SPI0
+{
+    constexpr auto RX = 4;
+    constexpr auto SCK = 6;
+    constexpr auto TX = 7;
+}
+
+namespace
+{
+    // The DMA interrupt handler has no context argument
+    PicoSpiTransport* activeTransport = nullptr;
+}
+
+PicoSpiTransport::PicoSpiTransport(const unsigned csPin, const unsigned dcPin)
+    : _csPin{ csPin }
+    , _dcPin{ dcPin }
+{}
+
+PicoSpiTransport::~PicoSpiTransport()
+{
+    waitForCompletion();
+
+    if (_rxChannel >= 0) {
+        dma_channel_set_irq0_enabled(_rxChannel, false);
+        irq_remove_handler(DMA_IRQ_0, dmaInterruptHandler);
+        dma_channel_unclaim(_rxChannel);
+    }
+
+    if (_txChannel >= 0) {
+        dma_channel_unclaim(_txChannel);
+    }
+
+    if (activeTransport == this) {
+        activeTransport = nullptr;
+    }
+}
+
+void PicoSpiTransport::init(const uint32_t clockHz, const uint8_t spiMode)
+{
+    spi_init(spi0, clockHz);
+
+    spi_set_format(
+        spi0,
+        8,
+        spiMode == 2 || spiMode == 3 ? SPI_CPOL_1 : SPI_CPOL_0,
+        spiMode == 1 || spiMode == 3 ? SPI_CPHA_1 : SPI_CPHA_0,
+        SPI_MSB_FIRST
+    );
+
+    gpio_set_function(Pins::SPI0::RX, GPIO_FUNC_SPI);
+    gpio_set_function(Pins::SPI0::SCK, GPIO_FUNC_SPI);
+    gpio_set_function(Pins::SPI0::TX, GPIO_FUNC_SPI);
+
+    if (_txChannel < 0) {
+        _txChannel = dma_claim_unused_channel(true);
+
+        auto config = dma_channel_get_default_config(_txChannel);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+        channel_config_set_read_increment(&config, true);
+        channel_config_set_write_increment(&config, false);
+        channel_config_set_dreq(&config, spi_get_dreq(spi0, true));
+
+        dma_channel_configure(
+            _txChannel,
+            &config,
+            &spi_get_hw(spi0)->dr,
+            nullptr,
+            0,
+            false
+        );
+    }
+
+    if (_rxChannel < 0) {
+        _rxChannel = dma_claim_unused_channel(true);
+
+        // Received bytes are dropped into a single sink byte
+        auto config = dma_channel_get_default_config(_rxChannel);
+        channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+        channel_config_set_read_increment(&config, false);
+        channel_config_set_write_increment(&config, false);
+        channel_config_set_dreq(&config, spi_get_dreq(spi0, false));
+
+        dma_channel_configure(
+            _rxChannel,
+            &config,
+            &_rxSink,
+            &spi_get_hw(spi0)->dr,
+            0,
+            false
+        );
+
+        activeTransport = this;
+
+        dma_channel_set_irq0_enabled(_rxChannel, true);
+        irq_add_shared_handler(
+            DMA_IRQ_0,
+            dmaInterruptHandler,
+            PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY
+        );
+        irq_set_enabled(DMA_IRQ_0, true);
+    }
+}
+
+void PicoSpiTransport::setChipSelectLevel(const bool level)
+{
+    gpio_put(_csPin, level);
+}
+
+void PicoSpiTransport::setDataCommandLevel(const bool level)
+{
+    gpio_put(_dcPin, level);
+}
+
+void PicoSpiTransport::write(const uint8_t* const data, const size_t length)
+{
+    spi_write_blocking(spi0, data, length);
+}
+
+void PicoSpiTransport::transmit(const TransferBuffer& buffer, CompletionHandler onComplete)
+{
+    waitForCompletion();
+
+    // Blocking writes leave the bus idle, but the RX DMA must not pick up
+    // stale bytes from the FIFO
+    while (spi_is_readable(spi0)) {
+        (void)spi_get_hw(spi0)->dr;
+    }
+
+    spi_get_hw(spi0)->icr = SPI_SSPICR_RORIC_BITS;
+
+    _buffer = &buffer;
+    _offset = 0;
+    _onComplete = std::move(onComplete);
+    _transferDone = false;
+    _busy = true;
+
+    processSegments();
+}
+
+void PicoSpiTransport::waitForCompletion()
+{
+    if (!_busy) {
+        return;
+    }
+
+    while (!_transferDone) {
+        tight_loop_contents();
+    }
+
+    _buffer = nullptr;
+
+    // Called before clearing the busy flag, so the frame is fully done
+    // by the time waitForCompletion() returns
+    if (auto onComplete = std::move(_onComplete)) {
+        _onComplete = nullptr;
+        onComplete();
+    }
+
+    _busy = false;
+}
+
+bool PicoSpiTransport::isBusy() const
+{
+    return _busy && !_transferDone;
+}
+
+void PicoSpiTransport::processSegments()
+{
+    // Runs when the bus is idle: from transmit() or after the RX channel
+    // received the last byte of the previous segment. Control lines are
+    // switched right away, the next byte segment is started on DMA and
+    // continued from the RX completion interrupt.
+    while (_offset < _buffer->size()) {
+        TransferBuffer::Segment segment;
+        _offset = _buffer->read(_offset, segment);
+
+        switch (segment.type) {
+            case TransferBuffer::SegmentType::ChipSelect:
+                gpio_put(_csPin, segment.level);
+                break;
+
+            case TransferBuffer::SegmentType::DataCommand:
+                gpio_put(_dcPin, segment.level);
+                break;
+
+            case TransferBuffer::SegmentType::Bytes:
+                if (segment.length > 0) {
+                    // RX first, so it is armed before the first byte
+                    // comes back
+                    dma_channel_transfer_to_buffer_now(
+                        _rxChannel,
+                        &_rxSink,
+                        segment.length
+                    );
+                    dma_channel_transfer_from_buffer_now(
+                        _txChannel,
+                        segment.data,
+                        segment.length
+                    );
+                    return;
+                }
+                break;
+        }
+    }
+
+    // The completion handler is left to waitForCompletion(), user code
+    // doesn't run in interrupt context
+    _transferDone = true;
+}
+
+void PicoSpiTransport::dmaInterruptHandler()
+{
+    auto* const transport = activeTransport;
+
+    if (!transport || transport->_rxChannel < 0) {
+        return;
+    }
+
+    // Shared handler, leave other channels to their own handlers
+    if (!dma_channel_get_irq0_status(transport->_rxChannel)) {
+        return;
+    }
+
+    dma_channel_acknowledge_irq0(transport->_rxChannel);
+
+    if (transport->_busy && !transport->_transferDone) {
+        transport->processSegments();
+    }
+}
+
+}
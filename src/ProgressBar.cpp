@@ -17,7 +17,7 @@
 #include "ProgressBar.h"
 
 #include <algorithm>
-#include <string>
+#include <cstring>
 
 namespace U8W
 {
@@ -38,10 +38,28 @@ void ProgressBar::setPosition(int pos)
     _position = pos;
 }
 
-void ProgressBar::setText(std::string text)
+void ProgressBar::setText(const std::string_view text)
 {
-    _text = std::move(text);
-    _useDefaultText = _text.empty();
+    const auto length = std::min(text.size(), MaxTextLength);
+    std::memcpy(_text, text.data(), length);
+    _text[length] = '\0';
+    _useDefaultText = length == 0;
+}
+
+void ProgressBar::setNumber(const int32_t value, const NumberFormat& format)
+{
+    formatNumber(_text, sizeof(_text), value, format);
+    _useDefaultText = false;
+}
+
+void ProgressBar::setFixedPoint(
+    const int32_t value,
+    const uint8_t decimals,
+    const NumberFormat& format
+)
+{
+    formatFixedPoint(_text, sizeof(_text), value, decimals, format);
+    _useDefaultText = false;
 }
 
 void ProgressBar::update()
@@ -62,16 +80,22 @@ void ProgressBar::update()
     }
 
     // Text
-    const auto& text = _useDefaultText ? std::to_string(_position) + '%' : _text;
-    if (!text.empty()) {
+    constexpr char Suffix[] = "%";
+    char defaultText[MaxNumberLength + sizeof(Suffix)];
+    if (_useDefaultText) {
+        formatNumber(defaultText, sizeof(defaultText), _position, NumberFormat{ 0, ' ', Suffix });
+    }
+
+    const auto* const text = _useDefaultText ? defaultText : _text;
+    if (text[0] != '\0') {
         u8g2_SetDrawColor(&_display, 2);
         u8g2_SetFont(&_display, u8g2_font_p01type_tr);
         u8g2_SetFontMode(&_display, 1);
-        const auto strW = u8g2_GetStrWidth(&_display, text.c_str());
+        const auto strW = u8g2_GetStrWidth(&_display, text);
         const auto strH = u8g2_GetMaxCharHeight(&_display);
         const auto textX = _rect.width() / 2 - strW / 2;
         const auto textY = _rect.height() / 2 - strH / 2 + u8g2_GetAscent(&_display);
-        u8g2_DrawStr(&_display, textX, textY, text.c_str());
+        u8g2_DrawStr(&_display, textX, textY, text);
     }
 }
 
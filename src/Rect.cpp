@@ -119,8 +119,6 @@ Rect Rect::operator&(const Rect& r) const noexcept
     return tmp;
 }
 
-}
-
 std::ostream& operator<<(std::ostream& os, const Rect& r)
 {
     os << '{'
@@ -132,3 +130,5 @@ std::ostream& operator<<(std::ostream& os, const Rect& r)
     return os;
 }
 
+}
+
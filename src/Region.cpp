@@ -0,0 +1,295 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "Region.h"
+
+#include <algorithm>
+
+namespace U8W
+{
+
+namespace
+{
+
+// Horizontal extent of a band, the right side is exclusive
+struct Span
+{
+    int left;
+    int right;
+
+    bool operator==(const Span& s) const
+    {
+        return left == s.left && right == s.right;
+    }
+};
+
+// Appends the spans of the band which contains the row y. Rectangles are
+// sorted by their top, so the scan can resume from the previous band.
+void collectBandSpans(
+    const std::vector<Rect>& rects,
+    size_t& index,
+    const int y,
+    std::vector<Span>& spans
+)
+{
+    spans.clear();
+
+    while (index < rects.size() && rects[index].bottom() < y) {
+        ++index;
+    }
+
+    for (auto i = index; i < rects.size() && rects[i].top() <= y; ++i) {
+        spans.push_back(Span{ rects[i].left(), rects[i].right() + 1 });
+    }
+}
+
+bool isInside(const std::vector<Span>& spans, size_t& index, const int x)
+{
+    while (index < spans.size() && spans[index].right <= x) {
+        ++index;
+    }
+
+    return index < spans.size() && spans[index].left <= x;
+}
+
+void combineSpans(
+    const std::vector<Span>& a,
+    const std::vector<Span>& b,
+    const bool keepA,
+    const bool keepB,
+    const bool keepBoth,
+    std::vector<Span>& result
+)
+{
+    result.clear();
+
+    std::vector<int> edges;
+    edges.reserve((a.size() + b.size()) * 2);
+
+    for (const auto& s : a) {
+        edges.push_back(s.left);
+        edges.push_back(s.right);
+    }
+
+    for (const auto& s : b) {
+        edges.push_back(s.left);
+        edges.push_back(s.right);
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    size_t ia = 0;
+    size_t ib = 0;
+
+    for (size_t i = 0; i + 1 < edges.size(); ++i) {
+        const auto inA = isInside(a, ia, edges[i]);
+        const auto inB = isInside(b, ib, edges[i]);
+
+        const auto keep =
+            (inA && inB && keepBoth)
+            || (inA && !inB && keepA)
+            || (!inA && inB && keepB);
+
+        if (!keep) {
+            continue;
+        }
+
+        if (!result.empty() && result.back().right == edges[i]) {
+            result.back().right = edges[i + 1];
+        } else {
+            result.push_back(Span{ edges[i], edges[i + 1] });
+        }
+    }
+}
+
+}
+
+Region::Region(const Rect& rect)
+{
+    if (!rect.isEmpty()) {
+        _rects.push_back(rect);
+        _boundingRect = rect;
+    }
+}
+
+bool Region::isEmpty() const
+{
+    return _rects.empty();
+}
+
+Rect Region::boundingRect() const
+{
+    return _boundingRect;
+}
+
+bool Region::intersects(const Rect& rect) const
+{
+    if ((_boundingRect & rect).isEmpty()) {
+        return false;
+    }
+
+    for (const auto& r : _rects) {
+        if (r.top() > rect.bottom()) {
+            break;
+        }
+
+        if (!(r & rect).isEmpty()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void Region::clear()
+{
+    _rects.clear();
+    _boundingRect = Rect{};
+}
+
+Region Region::operator|(const Region& r) const
+{
+    return combine(*this, r, Operation::Union);
+}
+
+Region Region::operator&(const Region& r) const
+{
+    return combine(*this, r, Operation::Intersection);
+}
+
+Region Region::operator-(const Region& r) const
+{
+    return combine(*this, r, Operation::Subtraction);
+}
+
+Region& Region::operator|=(const Region& r)
+{
+    *this = combine(*this, r, Operation::Union);
+    return *this;
+}
+
+Region& Region::operator&=(const Region& r)
+{
+    *this = combine(*this, r, Operation::Intersection);
+    return *this;
+}
+
+Region& Region::operator-=(const Region& r)
+{
+    *this = combine(*this, r, Operation::Subtraction);
+    return *this;
+}
+
+Region Region::combine(const Region& a, const Region& b, const Operation op)
+{
+    const auto disjoint = (a._boundingRect & b._boundingRect).isEmpty();
+
+    switch (op) {
+        case Operation::Union:
+            if (b.isEmpty()) {
+                return a;
+            }
+            if (a.isEmpty()) {
+                return b;
+            }
+            break;
+
+        case Operation::Intersection:
+            if (disjoint) {
+                return Region{};
+            }
+            break;
+
+        case Operation::Subtraction:
+            if (disjoint) {
+                return a;
+            }
+            break;
+    }
+
+    const auto keepA = op != Operation::Intersection;
+    const auto keepB = op == Operation::Union;
+    const auto keepBoth = op != Operation::Subtraction;
+
+    // Every top and bottom edge starts a new band
+    std::vector<int> edges;
+    edges.reserve((a._rects.size() + b._rects.size()) * 2);
+
+    for (const auto* region : { &a, &b }) {
+        for (const auto& r : region->_rects) {
+            edges.push_back(r.top());
+            edges.push_back(r.bottom() + 1);
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    Region result;
+
+    std::vector<Span> spansA;
+    std::vector<Span> spansB;
+    std::vector<Span> spans;
+    std::vector<Span> previousSpans;
+    size_t indexA = 0;
+    size_t indexB = 0;
+    size_t previousBandStart = 0;
+    auto previousBandBottom = 0;
+
+    for (size_t i = 0; i + 1 < edges.size(); ++i) {
+        const auto top = edges[i];
+        const auto bottom = edges[i + 1] - 1;
+
+        collectBandSpans(a._rects, indexA, top, spansA);
+        collectBandSpans(b._rects, indexB, top, spansB);
+        combineSpans(spansA, spansB, keepA, keepB, keepBoth, spans);
+
+        if (spans.empty()) {
+            continue;
+        }
+
+        // Extend the previous band if it has the same spans and touches
+        // this one
+        if (
+            !result._rects.empty()
+            && previousBandBottom == top - 1
+            && previousSpans == spans
+        ) {
+            for (auto j = previousBandStart; j < result._rects.size(); ++j) {
+                result._rects[j].setBottom(bottom);
+            }
+        } else {
+            previousBandStart = result._rects.size();
+
+            for (const auto& s : spans) {
+                result._rects.push_back(Rect{ Point{ s.left, top }, Point{ s.right - 1, bottom } });
+            }
+
+            std::swap(previousSpans, spans);
+        }
+
+        previousBandBottom = bottom;
+    }
+
+    for (const auto& r : result._rects) {
+        result._boundingRect |= r;
+    }
+
+    return result;
+}
+
+}
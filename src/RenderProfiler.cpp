@@ -0,0 +1,121 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "RenderProfiler.h"
+
+#include <cstring>
+
+namespace U8W
+{
+
+namespace
+{
+
+const char* reasonName(const RenderProfiler::Reason reason)
+{
+    switch (reason) {
+        case RenderProfiler::Reason::Self:
+            return "self";
+        case RenderProfiler::Reason::Parent:
+            return "parent";
+        case RenderProfiler::Reason::Child:
+            return "child";
+        case RenderProfiler::Reason::Damage:
+            return "damage";
+    }
+
+    return "";
+}
+
+}
+
+RenderProfiler::RenderProfiler(Clock& clock)
+    : _clock{ clock }
+{}
+
+Clock& RenderProfiler::clock() const
+{
+    return _clock;
+}
+
+void RenderProfiler::beginFrame()
+{
+    if (_frameHasRecords) {
+        ++_frame;
+        _frameHasRecords = false;
+    }
+}
+
+void RenderProfiler::record(
+    const char* const name,
+    const Reason reason,
+    const uint32_t paintTime,
+    const uint32_t pixelsCleared,
+    const uint32_t drawCalls
+)
+{
+    auto& r = _records[_next];
+
+    r.frame = _frame;
+    r.paintTime = paintTime;
+    r.pixelsCleared = pixelsCleared;
+    r.drawCalls = static_cast<uint16_t>(drawCalls);
+    r.reason = reason;
+    std::strncpy(r.name, name, MaxNameLength);
+    r.name[MaxNameLength] = '\0';
+
+    _next = (_next + 1) % Capacity;
+
+    if (_size < Capacity) {
+        ++_size;
+    }
+
+    _frameHasRecords = true;
+}
+
+size_t RenderProfiler::size() const
+{
+    return _size;
+}
+
+const RenderProfiler::Record& RenderProfiler::at(const size_t index) const
+{
+    return _records[(_next + Capacity - _size + index) % Capacity];
+}
+
+void RenderProfiler::clear()
+{
+    _next = 0;
+    _size = 0;
+    _frameHasRecords = false;
+}
+
+void RenderProfiler::dump(std::ostream& os) const
+{
+    for (size_t i = 0; i < _size; ++i) {
+        const auto& r = at(i);
+
+        os << "frame=" << r.frame
+            << ", widget=" << r.name
+            << ", reason=" << reasonName(r.reason)
+            << ", time=" << r.paintTime << "us"
+            << ", pixelsCleared=" << r.pixelsCleared
+            << ", drawCalls=" << r.drawCalls
+            << '\n';
+    }
+}
+
+}
@@ -16,9 +16,14 @@
 
 #include "Size.h"
 
+namespace U8W
+{
+
 std::ostream& operator<<(std::ostream& os, const Size& s)
 {
     os << '{' << s._w << 'x' << s._h << '}';
 
     return os;
 }
+
+}
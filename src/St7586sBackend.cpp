@@ -0,0 +1,122 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "St7586sBackend.h"
+
+#include <hardware/gpio.h>
+#include <hardware/pwm.h>
+
+#include <pico/time.h>
+
+namespace U8W
+{
+
+namespace Pins
+{
+    constexpr auto CS = 5;
+    constexpr auto DC = 8;
+    constexpr auto RST = 9;
+
+    constexpr auto BacklightPwm = 0;
+}
+
+extern "C" uint8_t u8x8_d_st7586s_erc240160_chunked(
+    u8x8_t* const u8x8,
+    const uint8_t msg,
+    const uint8_t arg_int,
+    void* const arg_ptr
+);
+
+extern "C" uint8_t u8x8_gpio_and_delay_pico(
+    u8x8_t* const u8g2,
+    const uint8_t msg,
+    const uint8_t arg_int,
+    void* const arg_ptr
+)
+{
+    switch (msg)
+    {
+        case U8X8_MSG_GPIO_AND_DELAY_INIT:
+            gpio_init(Pins::CS);
+            gpio_init(Pins::DC);
+            gpio_init(Pins::RST);
+            gpio_set_dir(Pins::CS, true);
+            gpio_set_dir(Pins::DC, true);
+            gpio_set_dir(Pins::RST, true);
+            break;
+
+        case U8X8_MSG_DELAY_MILLI:
+            sleep_ms(arg_int);
+            break;
+
+        case U8X8_MSG_GPIO_DC:
+            gpio_put(Pins::DC, !!arg_int);
+            break;
+
+        case U8X8_MSG_GPIO_CS:
+            gpio_put(Pins::CS, !!arg_int);
+            break;
+
+        case U8X8_MSG_GPIO_RESET:
+            gpio_put(Pins::RST, !!arg_int);
+            break;
+
+        default:
+            return 0;
+    }
+
+    return 1;
+}
+
+St7586sBackend::St7586sBackend()
+    : _spiTransport{ Pins::CS, Pins::DC }
+    , _transport{ _spiTransport, MaxRunLength }
+{}
+
+void St7586sBackend::setupDisplay(u8g2_t* const u8g2, const u8x8_msg_cb byteCallback)
+{
+    u8g2_SetupDisplay(
+        u8g2,
+        u8x8_d_st7586s_erc240160_chunked,
+        u8x8_cad_011,
+        byteCallback,
+        u8x8_gpio_and_delay_pico
+    );
+}
+
+void St7586sBackend::init()
+{
+    // Setup the backlight control PWM pin
+    gpio_set_function(Pins::BacklightPwm, GPIO_FUNC_PWM);
+    const auto blPwmPinSlice = pwm_gpio_to_slice_num(Pins::BacklightPwm);
+    auto blPwmConfig = pwm_get_default_config();
+    pwm_config_set_clkdiv(&blPwmConfig, 4.f);
+    pwm_config_set_wrap(&blPwmConfig, 255 * 255);
+    pwm_init(blPwmPinSlice, &blPwmConfig, true);
+    // setBacklightLevel(60);
+}
+
+Transport& St7586sBackend::transport()
+{
+    return _transport;
+}
+
+void St7586sBackend::setBacklightLevel(const uint8_t value)
+{
+    pwm_set_gpio_level(Pins::BacklightPwm, value * value);
+}
+
+}
@@ -0,0 +1,104 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "TextWidthCache.h"
+
+#include <cstring>
+
+namespace U8W
+{
+
+int TextWidthCache::find(const uint8_t* const font, const char* const text, const size_t length)
+{
+    if (length <= MaxTextLength) {
+        const auto h = hash(text, length);
+
+        for (auto& entry : _entries) {
+            if (
+                entry.font == font
+                && entry.hash == h
+                && entry.length == length
+                && std::memcmp(entry.text, text, length) == 0
+            ) {
+                entry.lastUse = ++_useCounter;
+                ++_statistics.hits;
+                return entry.width;
+            }
+        }
+    }
+
+    ++_statistics.misses;
+    return -1;
+}
+
+void TextWidthCache::insert(
+    const uint8_t* const font,
+    const char* const text,
+    const size_t length,
+    const int width
+)
+{
+    if (length > MaxTextLength) {
+        return;
+    }
+
+    // Unused entries have a zero lastUse, so they are taken first
+    auto* victim = &_entries[0];
+
+    for (auto& entry : _entries) {
+        if (entry.lastUse < victim->lastUse) {
+            victim = &entry;
+        }
+    }
+
+    victim->font = font;
+    victim->hash = hash(text, length);
+    victim->lastUse = ++_useCounter;
+    victim->width = static_cast<int16_t>(width);
+    victim->length = static_cast<uint8_t>(length);
+    std::memcpy(victim->text, text, length);
+}
+
+void TextWidthCache::clear()
+{
+    _entries = {};
+    _useCounter = 0;
+}
+
+const TextWidthCache::Statistics& TextWidthCache::statistics() const
+{
+    return _statistics;
+}
+
+void TextWidthCache::resetStatistics()
+{
+    _statistics = {};
+}
+
+uint32_t TextWidthCache::hash(const char* const text, const size_t length)
+{
+    // FNV-1a
+    uint32_t h = 2166136261u;
+
+    for (size_t i = 0; i < length; ++i) {
+        h ^= static_cast<uint8_t>(text[i]);
+        h *= 16777619u;
+    }
+
+    return h;
+}
+
+}
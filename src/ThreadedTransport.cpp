@@ -0,0 +1,122 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#if !PICO_ON_DEVICE
+
+#include "ThreadedTransport.h"
+
+namespace U8W
+{
+
+ThreadedTransport::ThreadedTransport(Transport& transport)
+    : _transport{ transport }
+    , _thread{ [this] { run(); } }
+{}
+
+ThreadedTransport::~ThreadedTransport()
+{
+    waitForCompletion();
+
+    {
+        std::lock_guard lock{ _mutex };
+        _stopping = true;
+    }
+
+    _condition.notify_all();
+    _thread.join();
+}
+
+void ThreadedTransport::init(const uint32_t clockHz, const uint8_t spiMode)
+{
+    _transport.init(clockHz, spiMode);
+}
+
+void ThreadedTransport::setChipSelectLevel(const bool level)
+{
+    _transport.setChipSelectLevel(level);
+}
+
+void ThreadedTransport::setDataCommandLevel(const bool level)
+{
+    _transport.setDataCommandLevel(level);
+}
+
+void ThreadedTransport::write(const uint8_t* const data, const size_t length)
+{
+    _transport.write(data, length);
+}
+
+void ThreadedTransport::transmit(const TransferBuffer& buffer, CompletionHandler onComplete)
+{
+    std::unique_lock lock{ _mutex };
+    _condition.wait(lock, [this] { return !_busy; });
+
+    _buffer = &buffer;
+    _onComplete = std::move(onComplete);
+    _busy = true;
+
+    lock.unlock();
+    _condition.notify_all();
+}
+
+void ThreadedTransport::waitForCompletion()
+{
+    std::unique_lock lock{ _mutex };
+    _condition.wait(lock, [this] { return !_busy; });
+}
+
+bool ThreadedTransport::isBusy() const
+{
+    std::lock_guard lock{ _mutex };
+    return _busy;
+}
+
+void ThreadedTransport::run()
+{
+    std::unique_lock lock{ _mutex };
+
+    while (true) {
+        _condition.wait(lock, [this] { return _stopping || _buffer; });
+
+        if (!_buffer) {
+            break;
+        }
+
+        const auto* const buffer = _buffer;
+        auto onComplete = std::move(_onComplete);
+
+        lock.unlock();
+
+        _transport.transmit(*buffer, {});
+
+        // Called before waking up waiters, so the frame is fully done
+        // by the time waitForCompletion() returns
+        if (onComplete) {
+            onComplete();
+        }
+
+        lock.lock();
+
+        _buffer = nullptr;
+        _busy = false;
+
+        _condition.notify_all();
+    }
+}
+
+}
+
+#endif
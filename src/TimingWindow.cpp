@@ -0,0 +1,79 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "TimingWindow.h"
+
+#include "Utils.h"
+
+#include <algorithm>
+
+namespace U8W
+{
+
+void TimingWindow::add(const uint32_t us)
+{
+    _min = _count == 0 ? us : Utils::min(_min, us);
+    _max = Utils::max(_max, us);
+    _sum += us;
+    ++_count;
+
+    _samples[_next] = us;
+    _next = (_next + 1) % Capacity;
+}
+
+void TimingWindow::reset()
+{
+    *this = TimingWindow{};
+}
+
+uint32_t TimingWindow::count() const
+{
+    return _count;
+}
+
+uint32_t TimingWindow::min() const
+{
+    return _min;
+}
+
+uint32_t TimingWindow::max() const
+{
+    return _max;
+}
+
+uint32_t TimingWindow::average() const
+{
+    return _count == 0 ? 0 : static_cast<uint32_t>(_sum / _count);
+}
+
+uint32_t TimingWindow::percentile(const int percent) const
+{
+    const auto n = Utils::min<size_t>(_count, Capacity);
+
+    if (n == 0) {
+        return 0;
+    }
+
+    auto samples = _samples;
+    const auto rank = (Utils::clamp(percent, 0, 100) * n + 99) / 100;
+    const auto index = rank == 0 ? 0 : rank - 1;
+
+    std::nth_element(samples.begin(), samples.begin() + index, samples.begin() + n);
+
+    return samples[index];
+}
+
+}
@@ -0,0 +1,109 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "TransferBuffer.h"
+
+#include "Utils.h"
+
+namespace U8W
+{
+
+void TransferBuffer::clear()
+{
+    // Keeps the capacity, so steady-state recording does not allocate
+    _data.clear();
+    _openSegment = NoOpenSegment;
+}
+
+void TransferBuffer::setChipSelectLevel(const bool level)
+{
+    appendHeader(SegmentType::ChipSelect, level);
+    _openSegment = NoOpenSegment;
+}
+
+void TransferBuffer::setDataCommandLevel(const bool level)
+{
+    appendHeader(SegmentType::DataCommand, level);
+    _openSegment = NoOpenSegment;
+}
+
+void TransferBuffer::append(const uint8_t* data, size_t length)
+{
+    while (length > 0) {
+        if (_openSegment == NoOpenSegment) {
+            _openSegment = _data.size();
+            appendHeader(SegmentType::Bytes, 0);
+        }
+
+        const size_t segmentLength =
+            _data[_openSegment + 1]
+            | (_data[_openSegment + 2] << 8);
+
+        const auto chunk = Utils::min(length, MaxSegmentLength - segmentLength);
+
+        _data.insert(_data.end(), data, data + chunk);
+
+        const auto newLength = segmentLength + chunk;
+        _data[_openSegment + 1] = newLength & 0xff;
+        _data[_openSegment + 2] = newLength >> 8;
+
+        if (newLength == MaxSegmentLength) {
+            _openSegment = NoOpenSegment;
+        }
+
+        data += chunk;
+        length -= chunk;
+    }
+}
+
+bool TransferBuffer::isEmpty() const
+{
+    return _data.empty();
+}
+
+size_t TransferBuffer::size() const
+{
+    return _data.size();
+}
+
+size_t TransferBuffer::read(const size_t offset, Segment& segment) const
+{
+    const auto* const header = _data.data() + offset;
+    const auto value = header[1] | (header[2] << 8);
+
+    segment.type = static_cast<SegmentType>(header[0]);
+
+    if (segment.type == SegmentType::Bytes) {
+        segment.level = false;
+        segment.data = header + HeaderSize;
+        segment.length = value;
+    } else {
+        segment.level = value != 0;
+        segment.data = nullptr;
+        segment.length = 0;
+    }
+
+    return offset + HeaderSize + segment.length;
+}
+
+void TransferBuffer::appendHeader(const SegmentType type, const uint16_t value)
+{
+    _data.push_back(static_cast<uint8_t>(type));
+    _data.push_back(value & 0xff);
+    _data.push_back(value >> 8);
+}
+
+}
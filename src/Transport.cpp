@@ -0,0 +1,50 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "Transport.h"
+
+namespace U8W
+{
+
+void Transport::transmit(const TransferBuffer& buffer, CompletionHandler onComplete)
+{
+    replay(buffer);
+
+    if (onComplete) {
+        onComplete();
+    }
+}
+
+void Transport::replay(const TransferBuffer& buffer)
+{
+    buffer.forEach([this](const TransferBuffer::Segment& segment) {
+        switch (segment.type) {
+            case TransferBuffer::SegmentType::ChipSelect:
+                setChipSelectLevel(segment.level);
+                break;
+
+            case TransferBuffer::SegmentType::DataCommand:
+                setDataCommandLevel(segment.level);
+                break;
+
+            case TransferBuffer::SegmentType::Bytes:
+                write(segment.data, segment.length);
+                break;
+        }
+    });
+}
+
+}
@@ -17,54 +17,84 @@
 #include "Widget.h"
 
 #include "Display.h"
-
-#include <algorithm>
+#include "DisplayList.h"
 
 namespace U8W
 {
 
+namespace
+{
+
+uint32_t nextCacheKey = 1;
+
+}
+
 Widget::Widget(Display* const display)
     : _display{ display }
     , _parent{ nullptr }
+    , _cacheKey{ nextCacheKey++ }
 {}
 
 Widget::Widget(Widget* parent)
     : _display{ parent->_display }
     , _parent{ parent }
+    , _cacheKey{ nextCacheKey++ }
 {
-    parent->_children.push_back(this);
+    _previousSibling = parent->_lastChild;
+
+    if (parent->_lastChild) {
+        parent->_lastChild->_nextSibling = this;
+    } else {
+        parent->_firstChild = this;
+    }
+
+    parent->_lastChild = this;
+
+    requestRepaint(true);
 }
 
 Widget::~Widget()
 {
-    if (_parent) {
-        _children.erase(
-            std::remove(
-                std::begin(_children),
-                std::end(_children),
-                this
-            )
-        );
+    if (!_parent) {
+        return;
+    }
+
+    if (_previousSibling) {
+        _previousSibling->_nextSibling = _nextSibling;
+    } else {
+        _parent->_firstChild = _nextSibling;
+    }
+
+    if (_nextSibling) {
+        _nextSibling->_previousSibling = _previousSibling;
+    } else {
+        _parent->_lastChild = _previousSibling;
     }
 }
 
-void Widget::setName(std::string name)
+void Widget::setName(const char* const name)
 {
-    _name = std::move(name);
+#if U8W_WIDGET_NAMES
+    _name = name;
+#else
+    (void)name;
+#endif
 }
 
 void Widget::setPos(Point p)
 {
     _rect.moveTopLeft(std::move(p));
-    _needsRepaint = true;
-    _parentNeedsRepaint = true;
+    requestRepaint(true);
+
+    invalidateGeometry();
 }
 
 void Widget::setSize(Size s)
 {
     _rect.setSize(std::move(s));
-    _needsRepaint = true;
-    _parentNeedsRepaint = true;
+    requestRepaint(true);
+
+    invalidateGeometry();
 
     onResize();
 }
@@ -72,8 +102,9 @@ void Widget::setSize(Size s)
 void Widget::setWidth(const int width)
 {
     _rect.setWidth(width);
-    _needsRepaint = true;
-    _parentNeedsRepaint = true;
+    requestRepaint(true);
+
+    invalidateGeometry();
 
     onResize();
 }
@@ -81,8 +112,9 @@ void Widget::setWidth(const int width)
 void Widget::setHeight(const int height)
 {
     _rect.setHeight(height);
-    _needsRepaint = true;
-    _parentNeedsRepaint = true;
+    requestRepaint(true);
+
+    invalidateGeometry();
 
     onResize();
 }
@@ -90,8 +122,9 @@ void Widget::setHeight(const int height)
 void Widget::setRect(Rect r)
 {
     _rect = std::move(r);
-    _needsRepaint = true;
-    _parentNeedsRepaint = true;
+    requestRepaint(true);
+
+    invalidateGeometry();
 
     onResize();
 }
@@ -99,20 +132,50 @@ void Widget::setRect(Rect r)
 void Widget::setBackgroundEnabled(const bool enabled)
 {
     _backgroundEnabled = enabled;
-    _needsRepaint = true;
+    requestRepaint();
 }
 
-Point Widget::mapToGlobal(const Point& p) const
+void Widget::setCacheMode(const CacheMode mode)
 {
-    Point mappedPoint = p;
-    const Widget* w = this;
+    _cacheMode = mode;
+    _bitmapCacheValid = false;
+}
 
-    while (w) {
-        mappedPoint = w->mapToParent(mappedPoint);
-        w = w->_parent;
+void Widget::setRetainedModeEnabled(const bool enabled)
+{
+    if (enabled && !_displayList) {
+        _displayList = std::make_unique<DisplayList>();
+    } else if (!enabled) {
+        _displayList.reset();
     }
 
-    return mappedPoint;
+    _displayListValid = false;
+}
+
+void Widget::setVisible(const bool visible)
+{
+    if (_visible == visible) {
+        return;
+    }
+
+    // The parent repaints the area of the widget either way, which must
+    // be requested while the widget is still visible
+    if (!visible) {
+        requestRepaint(true);
+    }
+
+    _visible = visible;
+
+    if (visible) {
+        requestRepaint(true);
+    }
+}
+
+Point Widget::mapToGlobal(const Point& p) const
+{
+    updateGeometry();
+
+    return p + _globalOffset;
 }
 
 Rect Widget::mapToGlobal(const Rect& r) const
@@ -123,6 +186,11 @@ Rect Widget::mapToGlobal(const Rect& r) const
     };
 }
 
+Rect Widget::globalRect() const
+{
+    return mapToGlobal(_rect);
+}
+
 Point Widget::mapToParent(const Point& p) const
 {
     if (!_parent) {
@@ -151,16 +219,102 @@ void Widget::paint()
 #endif
 }
 
+void Widget::requestRepaint(const bool parentToo)
+{
+    _partialRepaint = false;
+
+    markNeedsRepaint(parentToo);
+}
+
+void Widget::requestRepaint(const Rect& area)
+{
+    if (!_needsRepaint) {
+        _repaintArea = area;
+        _partialRepaint = true;
+    } else if (_partialRepaint) {
+        _repaintArea |= area;
+    }
+
+    markNeedsRepaint(false);
+}
+
+void Widget::markNeedsRepaint(const bool parentToo)
+{
+#if U8W_LATENCY_TRACING
+    if (!_invalidationTraced) {
+        if (const auto* tracer = _display->latencyTracer()) {
+            _invalidatedAt = tracer->now();
+            _invalidationTraced = true;
+        }
+    }
+#endif
+
+    _needsRepaint = true;
+    _parentNeedsRepaint |= parentToo;
+    _displayListValid = false;
+    _bitmapCacheValid = false;
+
+    // Hidden subtrees are repainted as a whole when they are shown
+    if (!_visible) {
+        return;
+    }
+
+    // Ancestors of a marked widget are already marked, and their cached
+    // subtree bitmaps are already invalid
+    for (auto* w = _parent; w && !w->_descendantNeedsRepaint; w = w->_parent) {
+        w->_descendantNeedsRepaint = true;
+        w->_bitmapCacheValid = false;
+
+        if (!w->_visible) {
+            break;
+        }
+    }
+}
+
 Rect Widget::calculateClipRect() const
 {
-    if (!_parent) {
-        return _rect;
+    updateGeometry();
+
+    return _globalClipRect;
+}
+
+void Widget::invalidateGeometry()
+{
+    // Valid geometry is only ever computed on top of valid ancestors,
+    // so the subtree of an invalid widget is already invalid
+    if (!_geometryValid) {
+        return;
     }
 
-    const auto selfGlobalRect = mapToGlobal(_rect);
-    const auto parentGlobalRect = _parent->mapToGlobal(_parent->_rect);
+    _geometryValid = false;
+
+    // The recorded draw calls and the cached bitmaps use global
+    // coordinates
+    _displayListValid = false;
+    _bitmapCacheValid = false;
+
+    for (auto* child = _firstChild; child; child = child->_nextSibling) {
+        child->invalidateGeometry();
+    }
+}
+
+void Widget::updateGeometry() const
+{
+    if (_geometryValid) {
+        return;
+    }
+
+    if (_parent) {
+        _parent->updateGeometry();
+
+        _globalOffset = _parent->_globalOffset + _parent->pos();
+        _globalClipRect = _parent->_globalClipRect & Rect{ _rect.topLeft() + _globalOffset, _rect.size() };
+    } else {
+        _globalOffset = Point{};
+        _globalClipRect = _rect;
+    }
 
-    return parentGlobalRect & selfGlobalRect;
+    _geometryValid = true;
 }
 
 }
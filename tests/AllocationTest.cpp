@@ -0,0 +1,205 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+// Counts the heap allocations while a screen is built in an arena and
+// while frames are painted and sent in steady state. Damage mode is
+// left out, its regions are built on the heap.
+
+#include "Arena.h"
+#include "Display.h"
+#include "Font.h"
+#include "HeadlessBackend.h"
+#include "Image.h"
+#include "Label.h"
+#include "Painter.h"
+#include "Test.h"
+#include "Widget.h"
+
+#include <array>
+#include <cstdlib>
+#include <memory>
+#include <new>
+
+namespace
+{
+
+bool counting = false;
+int allocations = 0;
+
+}
+
+void* operator new(const size_t size)
+{
+    if (counting) {
+        ++allocations;
+    }
+
+    if (auto* const p = std::malloc(size > 0 ? size : 1)) {
+        return p;
+    }
+
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* const p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* const p, size_t) noexcept
+{
+    std::free(p);
+}
+
+using namespace U8W;
+
+namespace
+{
+
+const unsigned char Icon[] = {
+    0xff, 0xff, 0x01, 0x80, 0xfd, 0xbf, 0x05, 0xa0,
+    0xf5, 0xaf, 0x15, 0xa8, 0xd5, 0xab, 0x55, 0xaa,
+    0x55, 0xaa, 0xd5, 0xab, 0x15, 0xa8, 0xf5, 0xaf,
+    0x05, 0xa0, 0xfd, 0xbf, 0x01, 0x80, 0xff, 0xff
+};
+
+class Screen
+{
+public:
+    explicit Screen(Display& display)
+        : root{ &display }
+    {
+        root.setRect(Rect{ Point{}, display.size() });
+
+        clock = _arena.create<Label>("12:00:00", &root);
+        clock->setFont(Font{ Font::Family::Pxl16x8_Mono });
+        clock->setRect(Rect{ 0, 0, 80, 14 });
+        clock->setIncrementalRedrawEnabled(true);
+
+        for (auto p = 0; p < 4; ++p) {
+            auto* const panel = _arena.create<Widget>(&root);
+            panel->setRect(Rect{ (p % 2) * 120, 16 + (p / 2) * 72, 120, 72 });
+            panels[p] = panel;
+
+            auto* const icon = _arena.create<Image>(Icon, 16, 16, panel);
+            icon->setPos(Point{ 100, 0 });
+
+            for (auto v = 0; v < 4; ++v) {
+                auto* const value = _arena.create<Label>(panel);
+                value->setRect(Rect{ 2, 16 + v * 14, 80, 12 });
+                value->setAlignment(Align::Right);
+                value->setNumber(v, NumberFormat{ 4, ' ', "ms" });
+                values[p * 4 + v] = value;
+            }
+        }
+    }
+
+    Widget root;
+    Label* clock = nullptr;
+    std::array<Widget*, 4> panels{};
+    std::array<Label*, 16> values{};
+
+private:
+    StaticArena<16 * 1024> _arena;
+};
+
+// Changes some labels, repaints a panel through its parent and sends
+// the frame. The texts keep their length, so the retained display lists
+// keep their size.
+void frame(Screen& screen, Painter& painter, Display& display, const int i)
+{
+    screen.values[i % 16]->setNumber(i % 1000, NumberFormat{ 4, ' ', "ms" });
+    screen.values[(i + 5) % 16]->setFixedPoint(i % 1000, 1, NumberFormat{ 5, ' ', " V" });
+    screen.clock->setNumber(i % 100'000, NumberFormat{ 8, '0' });
+    screen.panels[i % 4]->setBackgroundEnabled(true);
+
+    painter.renderWidget(&screen.root);
+    display.update();
+}
+
+void testScreenBuild(Display& display)
+{
+    auto storage = std::make_unique<std::aligned_storage_t<sizeof(Screen), alignof(Screen)>>();
+
+    allocations = 0;
+    counting = true;
+
+    auto* const screen = new (storage.get()) Screen{ display };
+
+    counting = false;
+
+    CHECK_EQUAL(allocations, 0);
+
+    screen->~Screen();
+}
+
+void testSteadyState(Display& display, const Display::UpdateMode mode)
+{
+    display.setUpdateMode(mode);
+
+    auto screen = std::make_unique<Screen>(display);
+
+    // Some of the widgets are retained and cached, their buffers are
+    // allocated on the first paint
+    for (auto i = 0; i < 16; i += 2) {
+        screen->values[i]->setRetainedModeEnabled(true);
+    }
+
+    screen->panels[3]->setCacheMode(Widget::CacheMode::BitmapWithChildren);
+    screen->values[1]->setCacheMode(Widget::CacheMode::Bitmap);
+
+    Painter painter;
+    painter.setBitmapCacheBudget(8 * 1024);
+
+    // Full repaints grow the painter's lists and both transfer buffers
+    // to their largest size
+    for (auto i = 0; i < 2; ++i) {
+        screen->root.setBackgroundEnabled(true);
+        frame(*screen, painter, display, i);
+    }
+
+    for (auto i = 0; i < 16; ++i) {
+        frame(*screen, painter, display, i);
+    }
+
+    allocations = 0;
+    counting = true;
+
+    for (auto i = 16; i < 200; ++i) {
+        frame(*screen, painter, display, i);
+    }
+
+    counting = false;
+    display.waitForUpdate();
+
+    CHECK_EQUAL(allocations, 0);
+    CHECK(painter.statistics().replays > 0);
+    CHECK(painter.bitmapCacheStatistics().hits > 0);
+}
+
+}
+
+int main()
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+
+    testScreenBuild(display);
+    testSteadyState(display, Display::UpdateMode::Synchronous);
+    testSteadyState(display, Display::UpdateMode::Asynchronous);
+
+    return TEST_RESULT();
+}
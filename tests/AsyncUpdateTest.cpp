@@ -0,0 +1,167 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "DisplayFixture.h"
+#include "RecordingTransport.h"
+#include "Test.h"
+
+#include <vector>
+
+using namespace U8W;
+using Test::RecordingTransport;
+
+namespace
+{
+
+using Events = std::vector<RecordingTransport::Event>;
+
+struct Fixture : Test::DisplayFixture<RecordingTransport>
+{
+    explicit Fixture(const Display::UpdateMode mode)
+    {
+        sendBlankFrame();
+        display.setUpdateMode(mode);
+        transport.reset();
+    }
+};
+
+void drawFirstFrame(Display& display)
+{
+    display.fillRect(Rect{ 10, 10, 30, 12 });
+    display.drawText(Point{ 100, 80 }, "42");
+    display.drawLine(Point{ 0, 159 }, Point{ 239, 100 });
+}
+
+void drawSecondFrame(Display& display)
+{
+    display.drawRect(Rect{ 180, 20, 40, 40 });
+}
+
+// The traffic of each frame sent synchronously
+std::vector<Events> synchronousFrames()
+{
+    Fixture f{ Display::UpdateMode::Synchronous };
+    std::vector<Events> frames;
+
+    drawFirstFrame(f.display);
+    f.display.update();
+    frames.push_back(f.transport.events());
+    f.transport.reset();
+
+    drawSecondFrame(f.display);
+    f.display.update();
+    frames.push_back(f.transport.events());
+
+    return frames;
+}
+
+void testRecordingMatchesSynchronousSend()
+{
+    const auto expected = synchronousFrames();
+
+    Fixture f{ Display::UpdateMode::Asynchronous };
+
+    drawFirstFrame(f.display);
+    f.display.update();
+    f.display.waitForUpdate();
+
+    CHECK(!expected[0].empty());
+    CHECK(f.transport.events() == expected[0]);
+    CHECK_EQUAL(f.transport.transmits(), 1);
+}
+
+void testSnapshot()
+{
+    const auto expected = synchronousFrames();
+
+    Fixture f{ Display::UpdateMode::Asynchronous };
+    f.transport.setDeferred(true);
+
+    drawFirstFrame(f.display);
+    f.display.update();
+
+    CHECK(f.display.isUpdateInProgress());
+    CHECK(f.transport.events().empty());
+
+    // Drawing while the frame is in flight must not change what is sent
+    f.display.clearBuffer();
+    f.display.fillRect(Rect{ 0, 0, 240, 160 });
+
+    f.transport.complete();
+
+    CHECK(!f.display.isUpdateInProgress());
+    CHECK(f.transport.events() == expected[0]);
+}
+
+void testBackPressure()
+{
+    const auto expected = synchronousFrames();
+
+    Fixture f{ Display::UpdateMode::Asynchronous };
+    f.transport.setDeferred(true);
+
+    auto completed = 0;
+    f.display.setUpdateCompletedCallback([&completed] { ++completed; });
+    f.transport.reset();
+
+    drawFirstFrame(f.display);
+    f.display.update();
+
+    CHECK_EQUAL(completed, 0);
+    CHECK(f.display.isUpdateInProgress());
+
+    // The second frame is recorded, then waits for the first one
+    drawSecondFrame(f.display);
+    f.display.update();
+
+    CHECK_EQUAL(completed, 1);
+    CHECK_EQUAL(f.transport.waits(), 2);
+    CHECK_EQUAL(f.transport.transmits(), 2);
+    CHECK_EQUAL(f.transport.transmitsWhileBusy(), 0);
+    CHECK(f.transport.events() == expected[0]);
+
+    f.display.waitForUpdate();
+
+    CHECK_EQUAL(completed, 2);
+
+    auto both = expected[0];
+    both.insert(both.end(), expected[1].begin(), expected[1].end());
+
+    CHECK(f.transport.events() == both);
+}
+
+void testUnchangedFrameIsNotTransmitted()
+{
+    Fixture f{ Display::UpdateMode::Asynchronous };
+    f.transport.setDeferred(true);
+
+    f.display.update();
+
+    CHECK_EQUAL(f.transport.transmits(), 0);
+    CHECK(!f.display.isUpdateInProgress());
+}
+
+}
+
+int main()
+{
+    testRecordingMatchesSynchronousSend();
+    testSnapshot();
+    testBackPressure();
+    testUnchangedFrameIsNotTransmitted();
+
+    return TEST_RESULT();
+}
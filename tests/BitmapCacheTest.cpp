@@ -0,0 +1,124 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+// Checks the bitmaps of cached subtrees against what the subtree
+// paints, with occlusion culling skipping parts of it
+
+#include "FrameBuffer.h"
+#include "HeadlessBackend.h"
+#include "Painter.h"
+#include "Test.h"
+#include "Widget.h"
+
+using namespace U8W;
+
+namespace
+{
+
+// Paints itself black
+class Marker : public Widget
+{
+public:
+    using Widget::Widget;
+
+protected:
+    void paint() override
+    {
+        _display->setDrawColor(Display::Color::Black);
+        _display->fillRect(globalRect());
+    }
+};
+
+struct Fixture
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+    Painter painter;
+    Widget root{ &display };
+    Widget panel{ &root };
+    Marker marker{ &panel };
+    Widget overlay{ &root };
+
+    explicit Fixture(const Painter::RepaintMode mode)
+    {
+        painter.setRepaintMode(mode);
+        painter.setOcclusionCullingEnabled(true);
+        painter.setBitmapCacheBudget(4 * 1024);
+
+        root.setRect(Rect{ Point{}, display.size() });
+        panel.setRect(Rect{ 0, 0, 100, 100 });
+        panel.setCacheMode(Widget::CacheMode::BitmapWithChildren);
+        marker.setRect(Rect{ 20, 20, 20, 20 });
+    }
+};
+
+void testCulledDescendantIsNotCaptured(const Painter::RepaintMode mode)
+{
+    Fixture f{ mode };
+
+    // The overlay hides the marker, which is culled
+    f.overlay.setRect(Rect{ 10, 10, 40, 40 });
+    f.painter.renderWidget(&f.root);
+    CHECK_EQUAL(f.painter.statistics().culledPaints, 1u);
+
+    // Moving it away repaints the panel through the root, the marker
+    // must not come back from a bitmap captured without it
+    f.overlay.setPos(Point{ 150, 10 });
+    f.painter.renderWidget(&f.root);
+    CHECK_EQUAL(Test::FrameBuffer{ f.display }.countWhite(Rect{ 20, 20, 20, 20 }), 0);
+
+    // Now the whole subtree was painted and captured, the panel is
+    // served from the bitmap when the overlay moves over it again
+    f.painter.resetBitmapCacheStatistics();
+    f.overlay.setPos(Point{ 60, 60 });
+    f.painter.renderWidget(&f.root);
+    CHECK_EQUAL(f.painter.bitmapCacheStatistics().hits, 1u);
+    CHECK_EQUAL(Test::FrameBuffer{ f.display }.countWhite(Rect{ 20, 20, 20, 20 }), 0);
+}
+
+void testMovingOverlay(const Painter::RepaintMode mode)
+{
+    Fixture f{ mode };
+
+    f.overlay.setRect(Rect{ 150, 10, 40, 40 });
+    f.painter.renderWidget(&f.root);
+
+    // The overlay passes over the marker and leaves it again, the panel
+    // must show the marker wherever it is uncovered
+    for (auto x = 0; x <= 150; x += 10) {
+        f.overlay.setPos(Point{ x, 10 });
+        f.painter.renderWidget(&f.root);
+
+        const Test::FrameBuffer pixels{ f.display };
+        const auto covered = Rect{ x, 10, 40, 40 } & Rect{ 20, 20, 20, 20 };
+        const auto coveredPixels = covered.isEmpty() ? 0 : covered.width() * covered.height();
+
+        CHECK_EQUAL(pixels.countWhite(Rect{ 20, 20, 20, 20 }), coveredPixels);
+    }
+}
+
+}
+
+int main()
+{
+    for (const auto mode : { Painter::RepaintMode::Full, Painter::RepaintMode::Damage }) {
+        testCulledDescendantIsNotCaptured(mode);
+        testMovingOverlay(mode);
+    }
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,117 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+// Checks that damage repainting covers the areas a moved widget left
+// and entered, and nothing else
+
+#include "FrameBuffer.h"
+#include "HeadlessBackend.h"
+#include "Painter.h"
+#include "Test.h"
+#include "Widget.h"
+
+using namespace U8W;
+
+namespace
+{
+
+struct Fixture
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+    Painter painter;
+    Widget root{ &display };
+    Widget box{ &root };
+
+    explicit Fixture(const Painter::RepaintMode mode)
+    {
+        painter.setRepaintMode(mode);
+        root.setRect(Rect{ Point{}, display.size() });
+        box.setRect(Rect{ 10, 10, 20, 16 });
+
+        painter.renderWidget(&root);
+    }
+
+    // Moves the box on a black buffer, the repainted pixels are white
+    void moveBox(const Point& pos)
+    {
+        Test::fillBlack(display);
+        box.setPos(pos);
+        painter.renderWidget(&root);
+    }
+};
+
+void testMoveRepaintsOldAndNewArea()
+{
+    Fixture f{ Painter::RepaintMode::Damage };
+
+    f.moveBox(Point{ 50, 40 });
+
+    const auto moved = Region{ Rect{ 10, 10, 20, 16 } } | Region{ Rect{ 50, 40, 20, 16 } };
+    CHECK(Test::FrameBuffer{ f.display }.isWhiteExactly(moved));
+
+    // Overlapping areas are repainted once
+    f.painter.resetStatistics();
+    f.moveBox(Point{ 55, 44 });
+
+    const auto shifted = Region{ Rect{ 50, 40, 20, 16 } } | Region{ Rect{ 55, 44, 20, 16 } };
+    CHECK(Test::FrameBuffer{ f.display }.isWhiteExactly(shifted));
+
+    // The box itself and the root under the exposed area
+    CHECK_EQUAL(f.painter.statistics().paints, shifted.rects().size() + 1);
+}
+
+void testCleanTreeIsNotRepainted()
+{
+    Fixture f{ Painter::RepaintMode::Damage };
+
+    Test::fillBlack(f.display);
+    CHECK(!f.painter.renderWidget(&f.root));
+    CHECK_EQUAL(Test::FrameBuffer{ f.display }.countWhite(), 0);
+}
+
+void testSwitchFromFullMode()
+{
+    // Full repaints move the box without storing its area
+    Fixture f{ Painter::RepaintMode::Full };
+    f.moveBox(Point{ 50, 40 });
+
+    // The first damage frame repaints everything, so the box doesn't
+    // leave a ghost at its last position
+    f.painter.setRepaintMode(Painter::RepaintMode::Damage);
+    f.moveBox(Point{ 100, 80 });
+
+    const auto& size = f.display.size();
+    CHECK_EQUAL(Test::FrameBuffer{ f.display }.countWhite(), size.width() * size.height());
+
+    // Then only the damage
+    f.moveBox(Point{ 120, 100 });
+
+    const auto moved = Region{ Rect{ 100, 80, 20, 16 } } | Region{ Rect{ 120, 100, 20, 16 } };
+    CHECK(Test::FrameBuffer{ f.display }.isWhiteExactly(moved));
+}
+
+}
+
+int main()
+{
+    testMoveRepaintsOldAndNewArea();
+    testCleanTreeIsNotRepainted();
+    testSwitchFromFullMode();
+
+    return TEST_RESULT();
+}
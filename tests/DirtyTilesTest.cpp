@@ -0,0 +1,156 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "CountingTransport.h"
+#include "DisplayFixture.h"
+#include "Test.h"
+
+using namespace U8W;
+
+namespace
+{
+
+// 30x20 tiles of 8 bytes
+constexpr auto FullFrameBytes = 30 * 20 * 8;
+
+struct Fixture : Test::DisplayFixture<CountingTransport>
+{
+    Fixture()
+    {
+        sendBlankFrame();
+        transport.resetStatistics();
+        display.resetUpdateStatistics();
+    }
+};
+
+void testNothingDrawn()
+{
+    Fixture f;
+
+    auto completed = 0;
+    f.display.setUpdateCompletedCallback([&completed] { ++completed; });
+
+    // Not reported as a transferred frame either
+    f.display.update();
+
+    CHECK_EQUAL(f.transport.statistics().bytes, 0u);
+    CHECK_EQUAL(f.transport.statistics().transfers, 0u);
+    CHECK_EQUAL(completed, 0);
+
+    f.display.fillRect(Rect{ 0, 0, 1, 1 });
+    f.display.update();
+
+    CHECK_EQUAL(completed, 1);
+}
+
+void testSingleTile()
+{
+    Fixture f;
+
+    f.display.fillRect(Rect{ 8, 16, 8, 8 });
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 1u);
+    CHECK_EQUAL(f.transport.statistics().bytes, 8u);
+    CHECK_EQUAL(f.transport.statistics().transfers, 1u);
+}
+
+void testTileBoundaries()
+{
+    Fixture f;
+
+    // Touches 2x2 tiles, sent as one window of two tile rows
+    f.display.fillRect(Rect{ 4, 4, 8, 8 });
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 4u);
+    CHECK_EQUAL(f.transport.statistics().bytes, 4u * 8);
+    CHECK_EQUAL(f.transport.statistics().transfers, 2u);
+}
+
+void testSeparateAreas()
+{
+    Fixture f;
+
+    f.display.drawLine(Point{ 0, 0 }, Point{ 7, 0 });
+    f.display.drawRect(Rect{ 232, 152, 8, 8 });
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 2u);
+    CHECK_EQUAL(f.transport.statistics().bytes, 2u * 8);
+}
+
+void testDigitChange()
+{
+    Fixture f;
+
+    f.display.drawText(Point{ 100, 80 }, "5");
+    f.display.update();
+
+    const auto bytes = f.transport.statistics().bytes;
+
+    CHECK(bytes > 0);
+    CHECK(bytes * 10 < FullFrameBytes);
+}
+
+void testFullUpdateThreshold()
+{
+    Fixture f;
+
+    f.display.setFullUpdateThreshold(50);
+
+    // 40% of the tiles are sent as windows
+    f.display.fillRect(Rect{ 0, 0, 240, 64 });
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 30u * 8);
+    CHECK_EQUAL(f.transport.statistics().bytes, 30u * 8 * 8);
+
+    f.display.resetUpdateStatistics();
+    f.transport.resetStatistics();
+
+    // 60% of the tiles trigger a full update
+    f.display.fillRect(Rect{ 0, 0, 240, 96 });
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 30u * 20);
+    CHECK_EQUAL(f.transport.statistics().bytes, static_cast<uint32_t>(FullFrameBytes));
+}
+
+void testClearBuffer()
+{
+    Fixture f;
+
+    f.display.clearBuffer();
+    f.display.update();
+
+    CHECK_EQUAL(f.transport.statistics().bytes, static_cast<uint32_t>(FullFrameBytes));
+}
+
+}
+
+int main()
+{
+    testNothingDrawn();
+    testSingleTile();
+    testTileBoundaries();
+    testSeparateAreas();
+    testDigitChange();
+    testFullUpdateThreshold();
+    testClearBuffer();
+
+    return TEST_RESULT();
+}
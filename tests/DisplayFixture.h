@@ -0,0 +1,50 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "Display.h"
+#include "HeadlessBackend.h"
+
+#include <utility>
+
+namespace U8W::Test
+{
+
+// A headless display sending through a test transport, the arguments
+// of the constructor are passed on to the transport
+template<typename TransportType>
+struct DisplayFixture
+{
+    TransportType transport;
+    HeadlessBackend backend{ &transport };
+    Display display{ backend };
+
+    template<typename... Args>
+    explicit DisplayFixture(Args&&... args)
+        : transport{ std::forward<Args>(args)... }
+    {}
+
+    // Sends a blank frame, so the panel content is known and nothing is
+    // left dirty
+    void sendBlankFrame()
+    {
+        display.clearBuffer();
+        display.update();
+    }
+};
+
+}
@@ -0,0 +1,146 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+// Checks that Display skips the u8g2 state calls which wouldn't change
+// anything. Every miss of the state cache is one u8g2 call.
+
+#include "DisplayList.h"
+#include "Font.h"
+#include "FrameBuffer.h"
+#include "HeadlessBackend.h"
+#include "Test.h"
+
+using namespace U8W;
+
+namespace
+{
+
+// Counts the u8g2 state calls made by the function
+template <typename Function>
+uint32_t u8g2Calls(Display& display, Function&& function)
+{
+    display.resetStateCacheStatistics();
+    function();
+    return display.stateCacheStatistics().misses;
+}
+
+void testDrawColor(Display& display)
+{
+    display.setDrawColor(Display::Color::White);
+
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.setDrawColor(Display::Color::White); }), 0u);
+    CHECK_EQUAL(display.stateCacheStatistics().hits, 1u);
+
+    CHECK_EQUAL(u8g2Calls(display, [&] {
+        display.setDrawColor(Display::Color::Black);
+        display.setDrawColor(Display::Color::Black);
+        display.setDrawColor(Display::Color::Xor);
+    }), 2u);
+}
+
+void testFont(Display& display)
+{
+    display.setFont(Font{ Font::Family::Pxl16x8 });
+
+    // Fonts are told apart by their data, not by the Font object
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.setFont(Font{ Font::Family::Pxl16x8 }); }), 0u);
+
+    CHECK_EQUAL(u8g2Calls(display, [&] {
+        display.setFont(Font{ Font::Family::BitCell });
+        display.setFont(Font{ Font::Family::BitCell });
+    }), 1u);
+
+    display.setFontMode(Display::FontMode::Transparent);
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.setFontMode(Display::FontMode::Transparent); }), 0u);
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.setFontMode(Display::FontMode::Solid); }), 1u);
+}
+
+void testClipRect(Display& display)
+{
+    const auto full = Rect{ Point{}, display.size() };
+
+    display.setClipRect(Rect{ 10, 10, 20, 20 });
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.setClipRect(Rect{ 10, 10, 20, 20 }); }), 0u);
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.setClipRect(Rect{ 10, 10, 20, 21 }); }), 1u);
+
+    // Compared after limiting them to the display
+    display.setClipRect(full);
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.setClipRect(Rect{ -5, -5, 300, 300 }); }), 0u);
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.resetClipRect(); }), 0u);
+
+    // Empty windows are all the same
+    display.setClipRect(Rect{ 300, 300, 10, 10 });
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.setClipRect(Rect{ 400, 0, 10, 10 }); }), 0u);
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.resetClipRect(); }), 1u);
+}
+
+void testSkippedCallsKeepTheState(Display& display)
+{
+    display.resetClipRect();
+    display.setDrawColor(Display::Color::White);
+    display.fillRect(Rect{ Point{}, display.size() });
+
+    display.setClipRect(Rect{ 10, 10, 20, 20 });
+    display.setDrawColor(Display::Color::Black);
+
+    // Redundant, the clip window and the color still apply
+    display.setClipRect(Rect{ 10, 10, 20, 20 });
+    display.setDrawColor(Display::Color::Black);
+    display.fillRect(Rect{ 0, 0, 100, 100 });
+
+    const Test::FrameBuffer pixels{ display };
+    CHECK_EQUAL(pixels.countWhite(Rect{ 10, 10, 20, 20 }), 0);
+    CHECK_EQUAL(pixels.countWhite(), display.size().width() * display.size().height() - 400);
+}
+
+void testRecordingKeepsSkippedCalls(Display& display)
+{
+    display.resetClipRect();
+    display.setDrawColor(Display::Color::Black);
+
+    // The call is recorded even though u8g2 already has the color, the
+    // replay may start from another one
+    DisplayList list;
+    display.beginRecording(&list);
+    display.setDrawColor(Display::Color::Black);
+    display.fillRect(Rect{ 0, 0, 8, 8 });
+    display.endRecording();
+
+    CHECK(!list.isEmpty());
+
+    display.setDrawColor(Display::Color::White);
+    display.fillRect(Rect{ Point{}, display.size() });
+
+    CHECK_EQUAL(u8g2Calls(display, [&] { display.replay(list); }), 1u);
+    CHECK_EQUAL(Test::FrameBuffer{ display }.countWhite(Rect{ 0, 0, 8, 8 }), 0);
+}
+
+}
+
+int main()
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+
+    testDrawColor(display);
+    testFont(display);
+    testClipRect(display);
+    testSkippedCallsKeepTheState(display);
+    testRecordingKeepsSkippedCalls(display);
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,167 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+// Checks the metrics parsed from the font headers against what u8g2
+// reports for every font the library selects
+
+#include "Font.h"
+#include "FontMetrics.h"
+#include "Test.h"
+
+#include <u8g2.h>
+
+#include <cstring>
+#include <initializer_list>
+
+using namespace U8W;
+
+namespace
+{
+
+void checkFont(u8g2_t& u8g2, const Font& font)
+{
+    const auto* const data = font.data();
+    CHECK(data != nullptr);
+
+    if (!data) {
+        return;
+    }
+
+    const auto& metrics = font.metrics();
+
+    u8g2_SetFont(&u8g2, data);
+
+    CHECK_EQUAL(metrics.ascent, u8g2_GetAscent(&u8g2));
+    CHECK_EQUAL(metrics.descent, u8g2_GetDescent(&u8g2));
+    CHECK_EQUAL(metrics.maxCharHeight, u8g2_GetMaxCharHeight(&u8g2));
+    CHECK_EQUAL(metrics.maxCharWidth, u8g2.font_info.max_char_width);
+    CHECK_EQUAL(metrics.xOffset, u8g2.font_info.x_offset);
+
+    for (auto c = ' '; c <= '~'; ++c) {
+        // Both are 0 for missing glyphs
+        CHECK_EQUAL(FontMetrics::glyphAdvance(data, c), u8g2_GetGlyphWidth(&u8g2, c));
+    }
+
+    if (!font.isMonospace()) {
+        CHECK_EQUAL(metrics.fixedAdvance, 0);
+        return;
+    }
+
+    CHECK_EQUAL(metrics.fixedAdvance, u8g2_GetGlyphWidth(&u8g2, '0'));
+
+    // The cells of a monospace text hold the ink u8g2 measures
+    const char* const texts[] = { "0", "42", "1234567890" };
+
+    for (const auto* const text : texts) {
+        const auto length = std::strlen(text);
+        auto advances = 0;
+
+        for (size_t i = 0; i < length; ++i) {
+            advances += u8g2_GetGlyphWidth(&u8g2, text[i]);
+        }
+
+        CHECK_EQUAL(metrics.monospaceTextWidth(length), advances);
+        CHECK(metrics.monospaceTextWidth(length) >= u8g2_GetStrWidth(&u8g2, text));
+    }
+}
+
+void testCellSpan()
+{
+    FontMetrics metrics;
+    metrics.maxCharWidth = 7;
+    metrics.fixedAdvance = 7;
+
+    // Glyphs inside their cells
+    auto span = metrics.monospaceCellSpan(10, 2, 3);
+    CHECK_EQUAL(span.left, 24);
+    CHECK_EQUAL(span.right, 31);
+
+    // The bounding box starts left of the origin
+    metrics.xOffset = -1;
+    metrics.maxCharWidth = 8;
+    span = metrics.monospaceCellSpan(10, 2, 3);
+    CHECK_EQUAL(metrics.leftOverhang(), 1);
+    CHECK_EQUAL(metrics.rightOverhang(), 0);
+    CHECK_EQUAL(span.left, 23);
+    CHECK_EQUAL(span.right, 31);
+
+    // and reaches past the next cell
+    metrics.maxCharWidth = 10;
+    span = metrics.monospaceCellSpan(10, 2, 4);
+    CHECK_EQUAL(metrics.rightOverhang(), 2);
+    CHECK_EQUAL(span.left, 23);
+    CHECK_EQUAL(span.right, 40);
+
+    // Proportional fonts have no cells
+    metrics.fixedAdvance = 0;
+    CHECK(!metrics.isMonospace());
+}
+
+void testEmptyBitFields()
+{
+    const uint8_t data[] = { 0b1011'0110, 0b0000'0001 };
+    FontMetrics::BitReader reader{ data };
+
+    CHECK_EQUAL(reader.readSigned(0), 0);
+    CHECK_EQUAL(reader.readUnsigned(0), 0u);
+
+    // Empty fields don't move the read position
+    CHECK_EQUAL(reader.readUnsigned(3), 0b110u);
+    CHECK_EQUAL(reader.readSigned(0), 0);
+    CHECK_EQUAL(reader.readSigned(4), 0b0110 - 8);
+    CHECK_EQUAL(reader.readUnsigned(3), 0b011u);
+}
+
+}
+
+int main()
+{
+    testCellSpan();
+    testEmptyBitFields();
+
+    u8g2_t u8g2;
+    u8g2_Setup_null(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+
+    const Font::Family families[] = {
+        Font::Family::PfTempesta7,
+        Font::Family::RpgSystem,
+        Font::Family::Pxl16x8,
+        Font::Family::Pxl16x8_x2,
+        Font::Family::Pxl16x8_Mono,
+        Font::Family::Pxl16x8_Mono_x2,
+        Font::Family::BitCell,
+        Font::Family::BitCellMonoNumbers
+    };
+
+    const Font::Style styles[] = {
+        Font::Style::Regular,
+        Font::Style::Condensed,
+        Font::Style::Compressed
+    };
+
+    for (const auto family : families) {
+        for (const auto style : styles) {
+            for (const auto bold : { false, true }) {
+                Font font{ family, style };
+                font.setBold(bold);
+
+                checkFont(u8g2, font);
+            }
+        }
+    }
+
+    return TEST_RESULT();
+}
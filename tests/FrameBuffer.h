@@ -0,0 +1,120 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+#pragma once
+
+#include "Display.h"
+#include "Rect.h"
+#include "Region.h"
+#include "Test.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace U8W::Test
+{
+
+// Blackens the whole frame buffer. Widgets with a background paint it
+// white, so the pixels repainted by the next frame show up white.
+inline void fillBlack(Display& display)
+{
+    display.resetClipRect();
+    display.setDrawColor(Display::Color::Black);
+    display.fillRect(Rect{ Point{}, display.size() });
+}
+
+// Snapshot of the frame buffer of a headless display
+class FrameBuffer
+{
+public:
+    explicit FrameBuffer(const Display& display)
+        : _size{ display.size() }
+        , _stride{ (_size.width() + 7) / 8 }
+        , _bits(static_cast<size_t>(_stride * _size.height()))
+    {
+        CHECK(display.readPixels(Rect{ Point{}, _size }, _bits.data()));
+    }
+
+    [[nodiscard]] bool isBlack(const int x, const int y) const
+    {
+        return _bits[y * _stride + x / 8] & (0x80 >> (x % 8));
+    }
+
+    [[nodiscard]] int countWhite(const Rect& rect) const
+    {
+        auto count = 0;
+
+        for (auto y = rect.top(); y <= rect.bottom(); ++y) {
+            for (auto x = rect.left(); x <= rect.right(); ++x) {
+                count += isBlack(x, y) ? 0 : 1;
+            }
+        }
+
+        return count;
+    }
+
+    [[nodiscard]] int countWhite() const
+    {
+        return countWhite(Rect{ Point{}, _size });
+    }
+
+    // Bounding rectangle of the white pixels
+    [[nodiscard]] Rect whiteBounds() const
+    {
+        Rect bounds;
+
+        for (auto y = 0; y < _size.height(); ++y) {
+            for (auto x = 0; x < _size.width(); ++x) {
+                if (!isBlack(x, y)) {
+                    bounds |= Rect{ x, y, 1, 1 };
+                }
+            }
+        }
+
+        return bounds;
+    }
+
+    // True if exactly the pixels of the region are white
+    [[nodiscard]] bool isWhiteExactly(const Region& region) const
+    {
+        auto area = 0;
+
+        for (const auto& rect : region.rects()) {
+            const auto pixels = rect.width() * rect.height();
+
+            if (countWhite(rect) != pixels) {
+                return false;
+            }
+
+            area += pixels;
+        }
+
+        return countWhite() == area;
+    }
+
+    [[nodiscard]] bool operator==(const FrameBuffer& other) const
+    {
+        return _bits == other._bits;
+    }
+
+private:
+    const Size _size;
+    const int _stride;
+    std::vector<uint8_t> _bits;
+};
+
+}
@@ -0,0 +1,250 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "Clock.h"
+#include "DisplayFixture.h"
+#include "FrameScheduler.h"
+#include "Painter.h"
+#include "Test.h"
+#include "Transport.h"
+#include "Widget.h"
+
+using namespace U8W;
+
+namespace
+{
+
+// 50 frames per second
+constexpr uint32_t FrameInterval = 20'000;
+
+// Every write takes the same time
+class TimedTransport : public Transport
+{
+public:
+    static constexpr uint64_t WriteTime = 100;
+
+    explicit TimedTransport(ManualClock& clock)
+        : _clock{ clock }
+    {}
+
+    void init(uint32_t, uint8_t) override {}
+    void setChipSelectLevel(bool) override {}
+    void setDataCommandLevel(bool) override {}
+
+    void write(const uint8_t*, size_t) override
+    {
+        ++writes;
+        _clock.advance(WriteTime);
+    }
+
+    uint32_t writes = 0;
+
+private:
+    ManualClock& _clock;
+};
+
+// Takes paintTime to paint
+class TimedWidget : public Widget
+{
+public:
+    TimedWidget(Display* display, ManualClock& clock)
+        : Widget{ display }
+        , _clock{ clock }
+    {
+        setRect(Rect{ 0, 0, 16, 8 });
+    }
+
+    void change()
+    {
+        requestRepaint();
+    }
+
+    uint64_t paintTime = 1000;
+
+protected:
+    void paint() override
+    {
+        _clock.advance(paintTime);
+    }
+
+private:
+    ManualClock& _clock;
+};
+
+// Constructed before the transport, which advances it
+struct ClockFixture
+{
+    ManualClock clock;
+};
+
+struct Fixture : ClockFixture, Test::DisplayFixture<TimedTransport>
+{
+    TimedWidget root{ &display, clock };
+    Painter painter;
+    FrameScheduler scheduler{ &root, painter, display, clock };
+
+    Fixture()
+        : DisplayFixture{ clock }
+    {
+        scheduler.setMaxFrameRate(50);
+
+        // The first frame paints everything
+        scheduler.poll();
+        scheduler.resetStatistics();
+        transport.writes = 0;
+    }
+};
+
+void testNothingChanged()
+{
+    Fixture f;
+
+    f.clock.advance(FrameInterval);
+
+    CHECK(!f.scheduler.poll());
+    CHECK_EQUAL(f.scheduler.statistics().frames, 0u);
+    CHECK_EQUAL(f.scheduler.statistics().deferredPolls, 0u);
+}
+
+void testRateLimit()
+{
+    Fixture f;
+
+    // The first frame started at 0
+    f.clock.setMicroseconds(5'000);
+    f.root.change();
+
+    CHECK_EQUAL(f.scheduler.timeUntilNextFrame(), FrameInterval - 5'000);
+    CHECK(!f.scheduler.poll());
+    CHECK_EQUAL(f.scheduler.statistics().deferredPolls, 1u);
+
+    f.clock.setMicroseconds(19'999);
+
+    CHECK_EQUAL(f.scheduler.timeUntilNextFrame(), 1u);
+    CHECK(!f.scheduler.poll());
+    CHECK_EQUAL(f.scheduler.statistics().deferredPolls, 2u);
+
+    f.clock.setMicroseconds(FrameInterval);
+
+    CHECK_EQUAL(f.scheduler.timeUntilNextFrame(), 0u);
+    CHECK(f.scheduler.poll());
+    CHECK_EQUAL(f.scheduler.statistics().frames, 1u);
+
+    // The interval is measured from the start of the frame
+    f.root.change();
+    f.clock.setMicroseconds(2 * FrameInterval - 1);
+
+    CHECK(!f.scheduler.poll());
+
+    f.clock.setMicroseconds(2 * FrameInterval);
+
+    CHECK(f.scheduler.poll());
+    CHECK_EQUAL(f.scheduler.statistics().frames, 2u);
+    CHECK_EQUAL(f.scheduler.statistics().deferredPolls, 3u);
+    CHECK_EQUAL(f.scheduler.statistics().droppedFrames, 0u);
+}
+
+void testNoLimit()
+{
+    Fixture f;
+
+    f.scheduler.setMaxFrameRate(0);
+
+    for (auto i = 0; i < 5; ++i) {
+        f.root.change();
+        CHECK(f.scheduler.poll());
+    }
+
+    CHECK_EQUAL(f.scheduler.statistics().frames, 5u);
+    CHECK_EQUAL(f.scheduler.statistics().deferredPolls, 0u);
+    CHECK_EQUAL(f.scheduler.statistics().droppedFrames, 0u);
+}
+
+void testInvalidate()
+{
+    Fixture f;
+
+    f.clock.setMicroseconds(FrameInterval);
+    f.scheduler.invalidate();
+
+    CHECK(f.scheduler.poll());
+    CHECK_EQUAL(f.scheduler.statistics().frames, 1u);
+}
+
+void testDroppedFrames()
+{
+    Fixture f;
+
+    const auto frame = [&f](const uint64_t start, const uint64_t paintTime) {
+        f.clock.setMicroseconds(start);
+        f.root.paintTime = paintTime;
+        f.transport.writes = 0;
+        f.root.change();
+        CHECK(f.scheduler.poll());
+
+        // The time of the frame includes the transfer
+        return paintTime + f.transport.writes * TimedTransport::WriteTime;
+    };
+
+    // The transfer time is the same for every frame of the widget
+    const auto transferTime = frame(FrameInterval, 1'000) - 1'000;
+    CHECK(transferTime > 0);
+    CHECK_EQUAL(f.scheduler.statistics().droppedFrames, 0u);
+
+    // Takes exactly one interval
+    frame(2 * FrameInterval, FrameInterval - transferTime);
+    CHECK_EQUAL(f.scheduler.statistics().droppedFrames, 0u);
+
+    // Just over two intervals, misses two slots
+    frame(4 * FrameInterval, 2 * FrameInterval + 1 - transferTime);
+    CHECK_EQUAL(f.scheduler.statistics().droppedFrames, 2u);
+
+    // Exactly three intervals, misses two more
+    frame(7 * FrameInterval, 3 * FrameInterval - transferTime);
+    CHECK_EQUAL(f.scheduler.statistics().droppedFrames, 4u);
+}
+
+void testTimings()
+{
+    Fixture f;
+
+    f.clock.setMicroseconds(FrameInterval);
+    f.root.paintTime = 3'000;
+    f.root.change();
+
+    CHECK(f.scheduler.poll());
+
+    const auto& statistics = f.scheduler.statistics();
+
+    CHECK(f.transport.writes > 0);
+    CHECK_EQUAL(statistics.paintTime.count(), 1u);
+    CHECK_EQUAL(statistics.paintTime.max(), 3'000u);
+    CHECK_EQUAL(statistics.transferTime.max(), static_cast<uint32_t>(f.transport.writes * TimedTransport::WriteTime));
+}
+
+}
+
+int main()
+{
+    testNothingChanged();
+    testRateLimit();
+    testNoLimit();
+    testInvalidate();
+    testDroppedFrames();
+    testTimings();
+
+    return TEST_RESULT();
+}
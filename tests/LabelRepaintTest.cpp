@@ -0,0 +1,130 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+// Checks the area repainted by monospace labels when a digit changes,
+// and that it holds everything a full repaint would draw
+
+#include "Font.h"
+#include "FrameBuffer.h"
+#include "HeadlessBackend.h"
+#include "Label.h"
+#include "Painter.h"
+#include "Test.h"
+#include "Widget.h"
+
+using namespace U8W;
+
+namespace
+{
+
+struct Fixture
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+    Painter painter;
+    Widget root{ &display };
+    Label label{ "1234", &root };
+
+    explicit Fixture(const Font& font)
+    {
+        root.setRect(Rect{ Point{}, display.size() });
+
+        label.setFont(font);
+        label.setPos(Point{ 20, 30 });
+        label.setWidth(120);
+        label.setAlignment(Align::Right);
+        label.setIncrementalRedrawEnabled(true);
+
+        painter.renderWidget(&root);
+    }
+};
+
+void testOneDigitArea(const Font& font)
+{
+    Fixture f{ font };
+
+    Test::fillBlack(f.display);
+    f.painter.resetStatistics();
+
+    f.label.setText("1284");
+    f.painter.renderWidget(&f.root);
+
+    CHECK_EQUAL(f.painter.statistics().paints, 1u);
+
+    // Only the third cell and the overhangs of its glyphs
+    const auto& metrics = font.metrics();
+    const auto width = f.label.size().width();
+    const auto span = metrics.monospaceCellSpan(width - metrics.monospaceTextWidth(4), 2, 3);
+    const auto left = span.left > 0 ? span.left : 0;
+    const auto right = span.right < width ? span.right : width;
+
+    // The glyphs may cover the top and bottom rows of the area
+    const auto bounds = Test::FrameBuffer{ f.display }.whiteBounds();
+    CHECK_EQUAL(bounds.left(), 20 + left);
+    CHECK_EQUAL(bounds.right(), 20 + right - 1);
+    CHECK((bounds & f.label.globalRect()) == bounds);
+}
+
+void testMatchesFullRepaint(const Font& font)
+{
+    Fixture f{ font };
+
+    // Every digit to every other one, in each cell
+    for (auto from = '0'; from <= '9'; ++from) {
+        for (auto to = '0'; to <= '9'; ++to) {
+            for (auto cell = 0; cell < 4; ++cell) {
+                char text[] = "1234";
+                text[cell] = from;
+                f.label.setText(text);
+                f.painter.renderWidget(&f.root);
+
+                text[cell] = to;
+                f.label.setText(text);
+                f.painter.renderWidget(&f.root);
+
+                const Test::FrameBuffer incremental{ f.display };
+
+                // Moves the text by nothing, which repaints it all
+                f.label.setAlignment(Align::Right);
+                f.painter.renderWidget(&f.root);
+
+                CHECK(incremental == Test::FrameBuffer{ f.display });
+            }
+        }
+    }
+}
+
+}
+
+int main()
+{
+    const Font::Family families[] = {
+        Font::Family::Pxl16x8_Mono,
+        Font::Family::Pxl16x8_Mono_x2,
+        Font::Family::BitCellMonoNumbers
+    };
+
+    for (const auto family : families) {
+        const Font font{ family };
+        CHECK(font.isMonospace());
+
+        testOneDigitArea(font);
+        testMatchesFullRepaint(font);
+    }
+
+    return TEST_RESULT();
+}
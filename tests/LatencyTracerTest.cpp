@@ -0,0 +1,199 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "Clock.h"
+#include "LatencyTracer.h"
+#include "Test.h"
+
+#include <cstring>
+
+using namespace U8W;
+
+namespace
+{
+
+const LatencyTracer::WidgetLatency* findWidget(const LatencyTracer& tracer, const char* name)
+{
+    for (size_t i = 0; i < tracer.widgetCount(); ++i) {
+        if (std::strcmp(tracer.widget(i).name, name) == 0) {
+            return &tracer.widget(i);
+        }
+    }
+
+    return nullptr;
+}
+
+void testSynchronousFrame()
+{
+    ManualClock clock;
+    LatencyTracer tracer{ clock };
+
+    clock.setMicroseconds(1'000);
+    tracer.widgetPainted("clock", 200);
+    tracer.widgetPainted("value", 700);
+    tracer.frameSubmitted();
+
+    clock.setMicroseconds(1'500);
+    tracer.frameTransferred();
+
+    const auto* const clockWidget = findWidget(tracer, "clock");
+    const auto* const valueWidget = findWidget(tracer, "value");
+
+    CHECK(clockWidget && valueWidget);
+
+    if (clockWidget && valueWidget) {
+        CHECK_EQUAL(clockWidget->latency.max(), 1'300u);
+        CHECK_EQUAL(valueWidget->latency.max(), 800u);
+    }
+
+    // A frame is as late as its oldest invalidation
+    CHECK_EQUAL(tracer.frameLatency().count(), 1u);
+    CHECK_EQUAL(tracer.frameLatency().max(), 1'300u);
+    CHECK_EQUAL(tracer.droppedSamples(), 0u);
+}
+
+void testOverlappingFrames()
+{
+    ManualClock clock;
+    LatencyTracer tracer{ clock };
+
+    tracer.widgetPainted("a", 0);
+    tracer.frameSubmitted();
+
+    // The next frame is painted while the first one is in flight
+    clock.setMicroseconds(2'000);
+    tracer.widgetPainted("b", 1'000);
+
+    clock.setMicroseconds(3'000);
+    tracer.frameTransferred();
+
+    CHECK_EQUAL(tracer.frameLatency().count(), 1u);
+    CHECK_EQUAL(tracer.frameLatency().max(), 3'000u);
+    CHECK(findWidget(tracer, "b") && findWidget(tracer, "b")->latency.count() == 0);
+
+    tracer.frameSubmitted();
+
+    clock.setMicroseconds(5'000);
+    tracer.frameTransferred();
+
+    CHECK_EQUAL(tracer.frameLatency().count(), 2u);
+    CHECK_EQUAL(tracer.frameLatency().percentile(100), 4'000u);
+    CHECK_EQUAL(findWidget(tracer, "b")->latency.max(), 4'000u);
+}
+
+void testSkippedFrame()
+{
+    ManualClock clock;
+    LatencyTracer tracer{ clock };
+
+    tracer.widgetPainted("a", 0);
+    tracer.frameSubmitted();
+
+    // Painted without changing the panel, the frame in flight is kept
+    tracer.widgetPainted("b", 100);
+    tracer.frameSkipped();
+
+    clock.setMicroseconds(1'000);
+    tracer.frameTransferred();
+
+    CHECK_EQUAL(findWidget(tracer, "a")->latency.count(), 1u);
+    CHECK_EQUAL(findWidget(tracer, "b")->latency.count(), 0u);
+
+    // Nothing in flight, nothing recorded
+    tracer.frameTransferred();
+
+    CHECK_EQUAL(tracer.frameLatency().count(), 1u);
+}
+
+void testUntransferredFrame()
+{
+    ManualClock clock;
+    LatencyTracer tracer{ clock };
+
+    tracer.widgetPainted("a", 0);
+    tracer.widgetPainted("b", 0);
+    tracer.frameSubmitted();
+
+    // A transport which didn't report the completion
+    tracer.widgetPainted("c", 0);
+    tracer.frameSubmitted();
+
+    CHECK_EQUAL(tracer.droppedSamples(), 2u);
+
+    clock.setMicroseconds(100);
+    tracer.frameTransferred();
+
+    CHECK_EQUAL(tracer.frameLatency().count(), 1u);
+    CHECK_EQUAL(findWidget(tracer, "c")->latency.max(), 100u);
+}
+
+void testLimits()
+{
+    ManualClock clock;
+    LatencyTracer tracer{ clock };
+
+    char name[] = "w00";
+
+    for (size_t i = 0; i < LatencyTracer::MaxWidgets + 2; ++i) {
+        name[1] = static_cast<char>('0' + i / 10);
+        name[2] = static_cast<char>('0' + i % 10);
+        tracer.widgetPainted(name, 0);
+    }
+
+    CHECK_EQUAL(tracer.widgetCount(), LatencyTracer::MaxWidgets);
+    CHECK_EQUAL(tracer.droppedSamples(), 2u);
+
+    tracer.reset();
+
+    for (size_t i = 0; i < LatencyTracer::MaxPaintsPerFrame + 3; ++i) {
+        tracer.widgetPainted("same", 0);
+    }
+
+    CHECK_EQUAL(tracer.widgetCount(), 1u);
+    CHECK_EQUAL(tracer.droppedSamples(), 3u);
+
+    tracer.frameSubmitted();
+    tracer.frameTransferred();
+
+    CHECK_EQUAL(findWidget(tracer, "same")->latency.count(), static_cast<uint32_t>(LatencyTracer::MaxPaintsPerFrame));
+}
+
+void testLongNames()
+{
+    ManualClock clock;
+    LatencyTracer tracer{ clock };
+
+    // Names are told apart by their first MaxNameLength characters
+    tracer.widgetPainted("temperatureLabel1", 0);
+    tracer.widgetPainted("temperatureLabel2", 0);
+
+    CHECK_EQUAL(tracer.widgetCount(), 1u);
+    CHECK_EQUAL(std::strlen(tracer.widget(0).name), LatencyTracer::MaxNameLength);
+}
+
+}
+
+int main()
+{
+    testSynchronousFrame();
+    testOverlappingFrames();
+    testSkippedFrame();
+    testUntransferredFrame();
+    testLimits();
+    testLongNames();
+
+    return TEST_RESULT();
+}
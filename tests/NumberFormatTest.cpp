@@ -0,0 +1,73 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+// Checks the buffer sizes derived from MaxNumberLength and the
+// truncation of formatNumber()
+
+#include "NumberFormat.h"
+#include "Test.h"
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+using namespace U8W;
+
+namespace
+{
+
+void testLongestNumbers()
+{
+    char buffer[MaxNumberLength + 1];
+
+    CHECK_EQUAL(formatNumber(buffer, sizeof(buffer), std::numeric_limits<int32_t>::min()), MaxNumberLength);
+    CHECK(std::strcmp(buffer, "-2147483648") == 0);
+
+    CHECK_EQUAL(formatNumber(buffer, sizeof(buffer), std::numeric_limits<int32_t>::max()), MaxNumberLength - 1);
+    CHECK(std::strcmp(buffer, "2147483647") == 0);
+
+    // With a suffix, as the default text of ProgressBar
+    char percent[MaxNumberLength + sizeof("%")];
+    const auto length = formatNumber(
+        percent,
+        sizeof(percent),
+        std::numeric_limits<int32_t>::min(),
+        NumberFormat{ 0, ' ', "%" }
+    );
+    CHECK_EQUAL(length, MaxNumberLength + 1);
+    CHECK(std::strcmp(percent, "-2147483648%") == 0);
+}
+
+void testTruncation()
+{
+    char buffer[4];
+
+    CHECK_EQUAL(formatNumber(buffer, sizeof(buffer), 100, NumberFormat{ 0, ' ', "%" }), 3u);
+    CHECK(std::strcmp(buffer, "100") == 0);
+
+    CHECK_EQUAL(formatNumber(buffer, 0, 5), 0u);
+}
+
+}
+
+int main()
+{
+    testLongestNumbers();
+    testTruncation();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,188 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+// Checks which dirty widgets occlusion culling skips
+
+#include "Display.h"
+#include "HeadlessBackend.h"
+#include "Painter.h"
+#include "Test.h"
+#include "Widget.h"
+
+using namespace U8W;
+
+namespace
+{
+
+class CountingWidget : public Widget
+{
+public:
+    using Widget::Widget;
+
+    int paints = 0;
+
+protected:
+    void paint() override
+    {
+        ++paints;
+    }
+};
+
+struct Fixture
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+    Painter painter;
+    Widget root{ &display };
+    CountingWidget below{ &root };
+    CountingWidget box{ &root };
+    CountingWidget cover{ &root };
+    CountingWidget secondCover{ &root };
+
+    Fixture()
+    {
+        painter.setOcclusionCullingEnabled(true);
+
+        root.setRect(Rect{ Point{}, display.size() });
+        below.setRect(Rect{ 0, 0, 60, 60 });
+        box.setRect(Rect{ 20, 20, 20, 20 });
+        cover.setRect(Rect{ 100, 100, 10, 10 });
+        secondCover.setRect(Rect{ 120, 100, 10, 10 });
+
+        painter.renderWidget(&root);
+    }
+
+    // Moves the covers, which repaints the root and every widget
+    void paintBox(const Rect& coverRect, const Rect& secondCoverRect = Rect{ 120, 100, 10, 10 })
+    {
+        cover.setRect(coverRect);
+        secondCover.setRect(secondCoverRect);
+
+        below.paints = 0;
+        box.paints = 0;
+        painter.resetStatistics();
+        painter.renderWidget(&root);
+    }
+};
+
+void testFullCover()
+{
+    Fixture f;
+
+    f.paintBox(Rect{ 10, 10, 40, 40 });
+
+    CHECK_EQUAL(f.box.paints, 0);
+    CHECK_EQUAL(f.painter.statistics().culledPaints, 1u);
+    CHECK(!f.box.isRepaintPending());
+
+    // Exactly the box's area is still a full cover
+    f.paintBox(Rect{ 20, 20, 20, 20 });
+    CHECK_EQUAL(f.box.paints, 0);
+}
+
+void testCleanCover()
+{
+    Fixture f;
+    f.paintBox(Rect{ 10, 10, 40, 40 });
+
+    // Only the box is dirty, the cover isn't repainted but still hides it
+    f.box.paints = 0;
+    f.cover.paints = 0;
+    f.painter.resetStatistics();
+    f.box.setBackgroundEnabled(true);
+    CHECK(!f.painter.renderWidget(&f.root));
+
+    CHECK_EQUAL(f.box.paints, 0);
+    CHECK_EQUAL(f.cover.paints, 0);
+    CHECK_EQUAL(f.painter.statistics().culledPaints, 1u);
+}
+
+void testPartialCover()
+{
+    Fixture f;
+
+    f.paintBox(Rect{ 10, 10, 40, 20 });
+
+    CHECK_EQUAL(f.box.paints, 1);
+    CHECK_EQUAL(f.painter.statistics().culledPaints, 0u);
+
+    // One pixel left uncovered is enough
+    f.paintBox(Rect{ 20, 20, 20, 19 });
+    CHECK_EQUAL(f.box.paints, 1);
+}
+
+void testCombinedCover()
+{
+    Fixture f;
+
+    // Neither covers the box alone
+    f.paintBox(Rect{ 10, 10, 40, 20 }, Rect{ 10, 30, 40, 20 });
+
+    CHECK_EQUAL(f.box.paints, 0);
+    CHECK_EQUAL(f.painter.statistics().culledPaints, 1u);
+}
+
+void testTransparentCover()
+{
+    Fixture f;
+
+    // The box shows through a widget without background
+    f.cover.setBackgroundEnabled(false);
+    f.paintBox(Rect{ 10, 10, 40, 40 });
+
+    CHECK_EQUAL(f.box.paints, 1);
+    CHECK_EQUAL(f.painter.statistics().culledPaints, 0u);
+}
+
+void testCoverBelow()
+{
+    Fixture f;
+
+    // Widgets painted before the box don't hide it
+    f.below.setRect(Rect{ 0, 0, 80, 80 });
+    f.paintBox(Rect{ 100, 100, 10, 10 });
+
+    CHECK_EQUAL(f.box.paints, 1);
+    CHECK_EQUAL(f.below.paints, 1);
+    CHECK_EQUAL(f.painter.statistics().culledPaints, 0u);
+}
+
+void testDisabled()
+{
+    Fixture f;
+
+    f.painter.setOcclusionCullingEnabled(false);
+    f.paintBox(Rect{ 10, 10, 40, 40 });
+
+    CHECK_EQUAL(f.box.paints, 1);
+    CHECK_EQUAL(f.painter.statistics().culledPaints, 0u);
+}
+
+}
+
+int main()
+{
+    testFullCover();
+    testCleanCover();
+    testPartialCover();
+    testCombinedCover();
+    testTransparentCover();
+    testCoverBelow();
+    testDisabled();
+
+    return TEST_RESULT();
+}
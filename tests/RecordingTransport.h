@@ -0,0 +1,163 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+#include "Transport.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace U8W::Test
+{
+
+// Records the traffic as a list of events. Consecutive writes are
+// merged, so the same bytes compare equal however they were split.
+// Deferred transfers are held until complete() or waitForCompletion().
+class RecordingTransport : public Transport
+{
+public:
+    struct Event
+    {
+        enum class Type
+        {
+            ChipSelect,
+            DataCommand,
+            Bytes
+        };
+
+        Type type = Type::Bytes;
+        bool level = false;
+        std::vector<uint8_t> bytes;
+
+        bool operator==(const Event& other) const
+        {
+            return type == other.type && level == other.level && bytes == other.bytes;
+        }
+    };
+
+    void init(uint32_t, uint8_t) override {}
+
+    void setChipSelectLevel(const bool level) override
+    {
+        _events.push_back(Event{ Event::Type::ChipSelect, level, {} });
+    }
+
+    void setDataCommandLevel(const bool level) override
+    {
+        _events.push_back(Event{ Event::Type::DataCommand, level, {} });
+    }
+
+    void write(const uint8_t* const data, const size_t length) override
+    {
+        if (_events.empty() || _events.back().type != Event::Type::Bytes) {
+            _events.push_back(Event{});
+        }
+
+        auto& bytes = _events.back().bytes;
+        bytes.insert(bytes.end(), data, data + length);
+    }
+
+    void transmit(const TransferBuffer& buffer, CompletionHandler onComplete) override
+    {
+        ++_transmits;
+
+        if (!_deferred) {
+            Transport::transmit(buffer, std::move(onComplete));
+            return;
+        }
+
+        if (_pending) {
+            ++_transmitsWhileBusy;
+        }
+
+        _pending = &buffer;
+        _onComplete = std::move(onComplete);
+    }
+
+    void waitForCompletion() override
+    {
+        ++_waits;
+        complete();
+    }
+
+    [[nodiscard]] bool isBusy() const override
+    {
+        return _pending != nullptr;
+    }
+
+    // Sends the held transfer
+    void complete()
+    {
+        if (!_pending) {
+            return;
+        }
+
+        replay(*_pending);
+        _pending = nullptr;
+
+        auto onComplete = std::move(_onComplete);
+        _onComplete = nullptr;
+
+        if (onComplete) {
+            onComplete();
+        }
+    }
+
+    void setDeferred(const bool deferred)
+    {
+        _deferred = deferred;
+    }
+
+    [[nodiscard]] const std::vector<Event>& events() const
+    {
+        return _events;
+    }
+
+    [[nodiscard]] int transmits() const
+    {
+        return _transmits;
+    }
+
+    [[nodiscard]] int transmitsWhileBusy() const
+    {
+        return _transmitsWhileBusy;
+    }
+
+    [[nodiscard]] int waits() const
+    {
+        return _waits;
+    }
+
+    void reset()
+    {
+        _events.clear();
+        _transmits = 0;
+        _transmitsWhileBusy = 0;
+        _waits = 0;
+    }
+
+private:
+    std::vector<Event> _events;
+    bool _deferred = false;
+    const TransferBuffer* _pending = nullptr;
+    CompletionHandler _onComplete;
+    int _transmits = 0;
+    int _transmitsWhileBusy = 0;
+    int _waits = 0;
+};
+
+}
@@ -0,0 +1,178 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+// Checks the band structure of Region against hand-computed results
+
+#include "Region.h"
+#include "Test.h"
+
+#include <initializer_list>
+
+using namespace U8W;
+
+namespace
+{
+
+bool hasRects(const Region& region, std::initializer_list<Rect> expected)
+{
+    if (region.rects().size() != expected.size()) {
+        return false;
+    }
+
+    auto it = region.rects().begin();
+
+    for (const auto& rect : expected) {
+        if (*it++ != rect) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int area(const Region& region)
+{
+    auto pixels = 0;
+
+    for (const auto& rect : region.rects()) {
+        pixels += rect.width() * rect.height();
+    }
+
+    return pixels;
+}
+
+void testOverlappingBands()
+{
+    const Region a{ Rect{ 0, 0, 10, 10 } };
+    const Region b{ Rect{ 5, 5, 10, 10 } };
+
+    const auto united = a | b;
+    CHECK(hasRects(united, {
+        Rect{ 0, 0, 10, 5 },
+        Rect{ 0, 5, 15, 5 },
+        Rect{ 5, 10, 10, 5 }
+    }));
+    CHECK(united.boundingRect() == Rect(0, 0, 15, 15));
+
+    const auto intersected = a & b;
+    CHECK(hasRects(intersected, { Rect{ 5, 5, 5, 5 } }));
+
+    CHECK_EQUAL(area(united), area(a) + area(b) - area(intersected));
+
+    // Two spans in the middle band, the vertical neighbours differ
+    const auto threeBands = united | Region{ Rect{ 20, 7, 2, 2 } };
+    CHECK(hasRects(threeBands, {
+        Rect{ 0, 0, 10, 5 },
+        Rect{ 0, 5, 15, 2 },
+        Rect{ 0, 7, 15, 2 },
+        Rect{ 20, 7, 2, 2 },
+        Rect{ 0, 9, 15, 1 },
+        Rect{ 5, 10, 10, 5 }
+    }));
+}
+
+void testTouchingEdges()
+{
+    const Region left{ Rect{ 0, 0, 5, 5 } };
+    const Region right{ Rect{ 5, 0, 5, 5 } };
+    const Region below{ Rect{ 0, 5, 5, 5 } };
+
+    // Touching rectangles merge into one
+    CHECK(hasRects(left | right, { Rect{ 0, 0, 10, 5 } }));
+    CHECK(hasRects(left | below, { Rect{ 0, 0, 5, 10 } }));
+
+    // but share no pixels
+    CHECK((left & right).isEmpty());
+    CHECK((left & below).isEmpty());
+    CHECK(hasRects(left - right, { Rect{ 0, 0, 5, 5 } }));
+    CHECK(!left.intersects(Rect{ 5, 0, 5, 5 }));
+    CHECK(left.intersects(Rect{ 4, 4, 5, 5 }));
+
+    // Diagonal neighbours stay apart
+    const auto diagonal = left | Region{ Rect{ 5, 5, 5, 5 } };
+    CHECK(hasRects(diagonal, { Rect{ 0, 0, 5, 5 }, Rect{ 5, 5, 5, 5 } }));
+}
+
+void testSubtractHole()
+{
+    const Region outer{ Rect{ 0, 0, 10, 10 } };
+    const Region hole{ Rect{ 3, 3, 4, 4 } };
+
+    const auto ring = outer - hole;
+    CHECK(hasRects(ring, {
+        Rect{ 0, 0, 10, 3 },
+        Rect{ 0, 3, 3, 4 },
+        Rect{ 7, 3, 3, 4 },
+        Rect{ 0, 7, 10, 3 }
+    }));
+    CHECK_EQUAL(area(ring), 100 - 16);
+    CHECK(ring.boundingRect() == Rect(0, 0, 10, 10));
+
+    // The hole isn't part of the region
+    CHECK(!ring.intersects(Rect{ 3, 3, 4, 4 }));
+    CHECK(ring.intersects(Rect{ 2, 3, 2, 1 }));
+    CHECK((ring & hole).isEmpty());
+
+    // Filling it merges the bands again
+    CHECK(hasRects(ring | hole, { Rect{ 0, 0, 10, 10 } }));
+
+    // Subtracting everything leaves nothing
+    CHECK((ring - outer).isEmpty());
+}
+
+void testEmptyOperands()
+{
+    const Region empty;
+    const Region region{ Rect{ 2, 3, 4, 5 } };
+
+    CHECK(empty.isEmpty());
+    CHECK(empty.rects().empty());
+    CHECK(!empty.intersects(Rect{ 0, 0, 100, 100 }));
+
+    // Empty rectangles make empty regions
+    CHECK(Region(Rect{}).isEmpty());
+    CHECK(Region(Rect(5, 5, 0, 10)).isEmpty());
+
+    CHECK(hasRects(region | empty, { Rect{ 2, 3, 4, 5 } }));
+    CHECK(hasRects(empty | region, { Rect{ 2, 3, 4, 5 } }));
+    CHECK((region & empty).isEmpty());
+    CHECK((empty & region).isEmpty());
+    CHECK(hasRects(region - empty, { Rect{ 2, 3, 4, 5 } }));
+    CHECK((empty - region).isEmpty());
+    CHECK((empty | empty).isEmpty());
+
+    auto cleared = region;
+    cleared.clear();
+    CHECK(cleared.isEmpty());
+    CHECK(cleared.boundingRect().isEmpty());
+
+    cleared |= region;
+    CHECK(hasRects(cleared, { Rect{ 2, 3, 4, 5 } }));
+    CHECK(cleared.boundingRect() == Rect(2, 3, 4, 5));
+}
+
+}
+
+int main()
+{
+    testOverlappingBands();
+    testTouchingEdges();
+    testSubtractHole();
+    testEmptyOperands();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,274 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "DisplayFixture.h"
+#include "RecordingTransport.h"
+#include "Test.h"
+
+#include <array>
+#include <initializer_list>
+#include <vector>
+
+using namespace U8W;
+using Test::RecordingTransport;
+
+namespace
+{
+
+using Event = RecordingTransport::Event;
+using Events = std::vector<Event>;
+
+constexpr auto Columns = 30;
+constexpr auto Rows = 20;
+constexpr auto TileCount = Columns * Rows;
+
+// A window of tiles sent with u8g2_UpdateDisplayArea()
+struct Window
+{
+    int x;
+    int y;
+    int width;
+    int height = 1;
+};
+
+// The traffic of the windows for the current buffer content. Each tile
+// row is a transaction of its own, with the bytes u8g2 reads from the
+// buffer for it.
+Events windowTraffic(const Display& display, const std::initializer_list<Window> windows)
+{
+    // readPixels() of the whole display returns the u8g2 buffer layout
+    std::array<uint8_t, Columns * Rows * 8> buffer{};
+    CHECK(display.readPixels(Rect{ 0, 0, Columns * 8, Rows * 8 }, buffer.data()));
+
+    Events events;
+
+    for (const auto& window : windows) {
+        for (auto y = window.y; y < window.y + window.height; ++y) {
+            const auto* const tiles = buffer.data() + y * Columns * 8 + window.x * 8;
+
+            events.push_back(Event{ Event::Type::ChipSelect, false, {} });
+            events.push_back(Event{ Event::Type::DataCommand, true, {} });
+            events.push_back(Event{ Event::Type::Bytes, false, { tiles, tiles + window.width * 8 } });
+            events.push_back(Event{ Event::Type::ChipSelect, true, {} });
+        }
+    }
+
+    return events;
+}
+
+struct Fixture : Test::DisplayFixture<RecordingTransport>
+{
+    Fixture()
+    {
+        display.setShadowBufferEnabled(true);
+        sendBlankFrame();
+        reset();
+    }
+
+    void reset()
+    {
+        transport.reset();
+        display.resetUpdateStatistics();
+    }
+};
+
+void testFirstUpdateSendsEverything()
+{
+    Test::DisplayFixture<RecordingTransport> f;
+
+    f.display.update();
+    f.transport.reset();
+    f.display.resetUpdateStatistics();
+
+    f.display.setShadowBufferEnabled(true);
+    f.display.update();
+
+    // The panel content is unknown until the shadow is filled
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, static_cast<uint32_t>(TileCount));
+    CHECK_EQUAL(f.display.updateStatistics().tilesCompared, 0u);
+    CHECK(f.transport.events() == windowTraffic(f.display, { Window{ 0, 0, Columns, Rows } }));
+}
+
+void testIdenticalRedraw()
+{
+    Fixture f;
+
+    f.display.fillRect(Rect{ 8, 8, 8, 8 });
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 1u);
+    CHECK(f.transport.events() == windowTraffic(f.display, { Window{ 1, 1, 1 } }));
+
+    f.reset();
+
+    f.display.fillRect(Rect{ 8, 8, 8, 8 });
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesCompared, 1u);
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 0u);
+    CHECK_EQUAL(f.display.updateStatistics().bytesSaved, 8u);
+    CHECK(f.transport.events().empty());
+}
+
+void testChangedTilesOfDirtyArea()
+{
+    Fixture f;
+
+    f.display.fillRect(Rect{ 0, 0, 32, 8 });
+    f.display.update();
+
+    CHECK(f.transport.events() == windowTraffic(f.display, { Window{ 0, 0, 4 } }));
+
+    f.reset();
+
+    // Four dirty tiles, only the last one differs
+    f.display.fillRect(Rect{ 0, 0, 32, 8 });
+    f.display.setDrawColor(Color::White);
+    f.display.fillRect(Rect{ 24, 0, 8, 1 });
+    f.display.setDrawColor(Color::Black);
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesCompared, 4u);
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 1u);
+    CHECK_EQUAL(f.display.updateStatistics().bytesSaved, 3u * 8);
+    CHECK(f.transport.events() == windowTraffic(f.display, { Window{ 3, 0, 1 } }));
+}
+
+void testWordAndTailColumns()
+{
+    Fixture f;
+
+    // Column 5 is compared word-wise, column 29 in the tail of the row.
+    // Different tile rows, so each is sent as its own window.
+    f.display.fillRect(Rect{ 5 * 8, 80, 1, 1 });
+    f.display.fillRect(Rect{ 29 * 8 + 7, 103, 1, 1 });
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 2u);
+    CHECK(f.transport.events() == windowTraffic(f.display, { Window{ 5, 10, 1 }, Window{ 29, 12, 1 } }));
+
+    f.reset();
+
+    // Both tiles dirty again, the single pixels are cleared
+    f.display.setDrawColor(Color::White);
+    f.display.fillRect(Rect{ 5 * 8, 80, 1, 1 });
+    f.display.fillRect(Rect{ 29 * 8 + 7, 103, 1, 1 });
+    f.display.setDrawColor(Color::Black);
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesCompared, 2u);
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 2u);
+    CHECK(f.transport.events() == windowTraffic(f.display, { Window{ 5, 10, 1 }, Window{ 29, 12, 1 } }));
+
+    f.reset();
+
+    // Redrawn with the same content
+    f.display.setDrawColor(Color::White);
+    f.display.fillRect(Rect{ 5 * 8, 80, 8, 8 });
+    f.display.fillRect(Rect{ 29 * 8, 96, 8, 8 });
+    f.display.setDrawColor(Color::Black);
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesCompared, 2u);
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 0u);
+    CHECK(f.transport.events().empty());
+}
+
+void testChangedTilesKeepTheirWindow()
+{
+    Fixture f;
+
+    // Two tile rows with the same span are merged into one window
+    f.display.fillRect(Rect{ 16, 16, 24, 16 });
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 6u);
+    CHECK(f.transport.events() == windowTraffic(f.display, { Window{ 2, 2, 3, 2 } }));
+
+    f.reset();
+
+    // Only the middle tile of the lower row changes, the span of the
+    // upper row is dropped
+    f.display.fillRect(Rect{ 16, 16, 24, 16 });
+    f.display.setDrawColor(Color::White);
+    f.display.fillRect(Rect{ 26, 30, 4, 2 });
+    f.display.setDrawColor(Color::Black);
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesCompared, 6u);
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 1u);
+    CHECK(f.transport.events() == windowTraffic(f.display, { Window{ 3, 3, 1 } }));
+}
+
+void testRevertedChange()
+{
+    Fixture f;
+
+    f.display.fillRect(Rect{ 120, 64, 8, 8 });
+    f.display.update();
+    f.reset();
+
+    // Changed and changed back before the update
+    f.display.setDrawColor(Color::White);
+    f.display.fillRect(Rect{ 120, 64, 8, 8 });
+    f.display.setDrawColor(Color::Black);
+    f.display.fillRect(Rect{ 120, 64, 8, 8 });
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 0u);
+    CHECK(f.transport.events().empty());
+}
+
+void testShadowFollowsSentTiles()
+{
+    Fixture f;
+
+    f.display.fillRect(Rect{ 64, 32, 8, 8 });
+    f.display.update();
+    f.reset();
+
+    // The shadow holds the filled tile, so clearing half of it is a
+    // change
+    f.display.setDrawColor(Color::White);
+    f.display.fillRect(Rect{ 64, 32, 4, 8 });
+    f.display.setDrawColor(Color::Black);
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 1u);
+    CHECK(f.transport.events() == windowTraffic(f.display, { Window{ 8, 4, 1 } }));
+
+    f.reset();
+    f.display.update();
+
+    CHECK_EQUAL(f.display.updateStatistics().tilesCompared, 0u);
+    CHECK_EQUAL(f.display.updateStatistics().tilesSent, 0u);
+    CHECK(f.transport.events().empty());
+}
+
+}
+
+int main()
+{
+    testFirstUpdateSendsEverything();
+    testIdenticalRedraw();
+    testChangedTilesOfDirtyArea();
+    testWordAndTailColumns();
+    testChangedTilesKeepTheirWindow();
+    testRevertedChange();
+    testShadowFollowsSentTiles();
+
+    return TEST_RESULT();
+}
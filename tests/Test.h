@@ -0,0 +1,54 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#pragma once
+
+// Minimal checks for the host tests. Each test is an executable which
+// fails if any of its checks failed.
+
+#include <cstdio>
+
+namespace U8W::Test
+{
+
+inline int failures = 0;
+
+}
+
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition); \
+            ++U8W::Test::failures; \
+        } \
+    } while (false)
+
+#define CHECK_EQUAL(actual, expected) \
+    do { \
+        const auto _actual = (actual); \
+        const auto _expected = (expected); \
+        if (!(_actual == _expected)) { \
+            std::printf( \
+                "%s:%d: CHECK_EQUAL(%s, %s) failed: %lld != %lld\n", \
+                __FILE__, __LINE__, #actual, #expected, \
+                static_cast<long long>(_actual), static_cast<long long>(_expected) \
+            ); \
+            ++U8W::Test::failures; \
+        } \
+    } while (false)
+
+#define TEST_RESULT() \
+    (std::printf("%d check(s) failed\n", U8W::Test::failures), U8W::Test::failures == 0 ? 0 : 1)
@@ -0,0 +1,175 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+// Checks the hits, the LRU eviction and the long string bypass of the
+// text width cache, on its own and behind Display
+
+#include "Display.h"
+#include "Font.h"
+#include "HeadlessBackend.h"
+#include "Test.h"
+#include "TextWidthCache.h"
+
+#include <cstdio>
+#include <string>
+
+using namespace U8W;
+
+namespace
+{
+
+const uint8_t FontA[1] = {};
+const uint8_t FontB[1] = {};
+
+int find(TextWidthCache& cache, const uint8_t* const font, const std::string& text)
+{
+    return cache.find(font, text.data(), text.size());
+}
+
+void insert(TextWidthCache& cache, const uint8_t* const font, const std::string& text, const int width)
+{
+    cache.insert(font, text.data(), text.size(), width);
+}
+
+std::string numbered(const int i)
+{
+    char text[16];
+    std::snprintf(text, sizeof(text), "text %d", i);
+    return text;
+}
+
+void testHit()
+{
+    TextWidthCache cache;
+
+    CHECK_EQUAL(find(cache, FontA, "12:00"), -1);
+    insert(cache, FontA, "12:00", 30);
+
+    CHECK_EQUAL(find(cache, FontA, "12:00"), 30);
+    CHECK_EQUAL(cache.statistics().hits, 1u);
+    CHECK_EQUAL(cache.statistics().misses, 1u);
+
+    // The font, the length and the characters must all match
+    CHECK_EQUAL(find(cache, FontB, "12:00"), -1);
+    CHECK_EQUAL(find(cache, FontA, "12:0"), -1);
+    CHECK_EQUAL(find(cache, FontA, "12:01"), -1);
+    CHECK_EQUAL(cache.statistics().misses, 4u);
+
+    // The same text in another font is another entry
+    insert(cache, FontB, "12:00", 40);
+    CHECK_EQUAL(find(cache, FontA, "12:00"), 30);
+    CHECK_EQUAL(find(cache, FontB, "12:00"), 40);
+
+    cache.clear();
+    CHECK_EQUAL(find(cache, FontA, "12:00"), -1);
+}
+
+void testEviction()
+{
+    TextWidthCache cache;
+    const auto capacity = static_cast<int>(TextWidthCache::Capacity);
+
+    for (auto i = 0; i < capacity; ++i) {
+        insert(cache, FontA, numbered(i), i);
+    }
+
+    for (auto i = 0; i < capacity; ++i) {
+        CHECK_EQUAL(find(cache, FontA, numbered(i)), i);
+    }
+
+    // Used again, so text 1 is the least recently used one now
+    CHECK_EQUAL(find(cache, FontA, numbered(0)), 0);
+
+    insert(cache, FontA, numbered(capacity), capacity);
+
+    CHECK_EQUAL(find(cache, FontA, numbered(capacity)), capacity);
+    CHECK_EQUAL(find(cache, FontA, numbered(0)), 0);
+    CHECK_EQUAL(find(cache, FontA, numbered(1)), -1);
+
+    for (auto i = 2; i < capacity; ++i) {
+        CHECK_EQUAL(find(cache, FontA, numbered(i)), i);
+    }
+}
+
+void testLongStringBypass()
+{
+    TextWidthCache cache;
+
+    const std::string longest(TextWidthCache::MaxTextLength, 'x');
+    const std::string tooLong(TextWidthCache::MaxTextLength + 1, 'x');
+
+    insert(cache, FontA, longest, 100);
+    insert(cache, FontA, tooLong, 104);
+
+    CHECK_EQUAL(find(cache, FontA, longest), 100);
+    CHECK_EQUAL(find(cache, FontA, tooLong), -1);
+
+    // A bypassed string doesn't evict anything
+    for (auto i = 0; i < static_cast<int>(TextWidthCache::Capacity) - 1; ++i) {
+        insert(cache, FontA, numbered(i), i);
+    }
+
+    insert(cache, FontA, tooLong, 104);
+    CHECK_EQUAL(find(cache, FontA, longest), 100);
+    CHECK_EQUAL(find(cache, FontA, numbered(0)), 0);
+}
+
+void testDisplay()
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+    display.setFont(Font{ Font::Family::Pxl16x8 });
+
+    const auto width = display.calculateTextWidth("12:00");
+    CHECK(width > 0);
+
+    display.resetTextWidthCacheStatistics();
+    CHECK_EQUAL(display.calculateTextWidth("12:00"), width);
+    CHECK_EQUAL(display.calculateTextWidth(std::string{ "12:00" }), width);
+    CHECK_EQUAL(display.textWidthCacheStatistics().hits, 2u);
+
+    // Another font is measured again
+    display.setFont(Font{ Font::Family::BitCell });
+    const auto otherWidth = display.calculateTextWidth("12:00");
+    CHECK_EQUAL(display.textWidthCacheStatistics().hits, 2u);
+
+    display.setFont(Font{ Font::Family::Pxl16x8 });
+    CHECK_EQUAL(display.calculateTextWidth("12:00"), width);
+    display.setFont(Font{ Font::Family::BitCell });
+    CHECK_EQUAL(display.calculateTextWidth("12:00"), otherWidth);
+    CHECK_EQUAL(display.textWidthCacheStatistics().hits, 4u);
+
+    // Long strings are measured every time, with the same result
+    const std::string text(TextWidthCache::MaxTextLength + 1, '8');
+    const auto longWidth = display.calculateTextWidth(text);
+
+    display.resetTextWidthCacheStatistics();
+    CHECK_EQUAL(display.calculateTextWidth(text), longWidth);
+    CHECK_EQUAL(display.textWidthCacheStatistics().hits, 0u);
+}
+
+}
+
+int main()
+{
+    testHit();
+    testEviction();
+    testLongStringBypass();
+    testDisplay();
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,120 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+#include "Test.h"
+#include "TimingWindow.h"
+
+using namespace U8W;
+
+namespace
+{
+
+void testEmpty()
+{
+    TimingWindow window;
+
+    CHECK_EQUAL(window.count(), 0u);
+    CHECK_EQUAL(window.average(), 0u);
+    CHECK_EQUAL(window.percentile(50), 0u);
+}
+
+void testNearestRank()
+{
+    TimingWindow window;
+
+    // Added out of order, percentiles must not depend on it
+    for (uint32_t i = 0; i < 100; ++i) {
+        window.add((i * 37) % 100 + 1);
+    }
+
+    CHECK_EQUAL(window.count(), 100u);
+    CHECK_EQUAL(window.min(), 1u);
+    CHECK_EQUAL(window.max(), 100u);
+    CHECK_EQUAL(window.average(), 50u);
+
+    CHECK_EQUAL(window.percentile(0), 1u);
+    CHECK_EQUAL(window.percentile(1), 1u);
+    CHECK_EQUAL(window.percentile(50), 50u);
+    CHECK_EQUAL(window.percentile(90), 90u);
+    CHECK_EQUAL(window.percentile(99), 99u);
+    CHECK_EQUAL(window.percentile(100), 100u);
+
+    // Out of range percents are clamped
+    CHECK_EQUAL(window.percentile(-5), 1u);
+    CHECK_EQUAL(window.percentile(150), 100u);
+}
+
+void testSmallWindow()
+{
+    TimingWindow window;
+
+    window.add(30);
+    window.add(10);
+    window.add(20);
+
+    CHECK_EQUAL(window.percentile(0), 10u);
+    CHECK_EQUAL(window.percentile(33), 10u);
+    CHECK_EQUAL(window.percentile(34), 20u);
+    CHECK_EQUAL(window.percentile(50), 20u);
+    CHECK_EQUAL(window.percentile(67), 30u);
+    CHECK_EQUAL(window.percentile(100), 30u);
+}
+
+void testWrapAround()
+{
+    TimingWindow window;
+
+    for (uint32_t i = 1; i <= 200; ++i) {
+        window.add(i);
+    }
+
+    // The percentiles cover the last Capacity samples (73..200), the
+    // other values the whole lifetime of the window
+    CHECK_EQUAL(window.count(), 200u);
+    CHECK_EQUAL(window.min(), 1u);
+    CHECK_EQUAL(window.max(), 200u);
+    CHECK_EQUAL(window.average(), 100u);
+
+    CHECK_EQUAL(window.percentile(0), 73u);
+    CHECK_EQUAL(window.percentile(50), 136u);
+    CHECK_EQUAL(window.percentile(100), 200u);
+}
+
+void testReset()
+{
+    TimingWindow window;
+
+    window.add(5);
+    window.reset();
+
+    CHECK_EQUAL(window.count(), 0u);
+    CHECK_EQUAL(window.min(), 0u);
+    CHECK_EQUAL(window.max(), 0u);
+    CHECK_EQUAL(window.percentile(100), 0u);
+}
+
+}
+
+int main()
+{
+    testEmpty();
+    testNearestRank();
+    testSmallWindow();
+    testWrapAround();
+    testReset();
+
+    return TEST_RESULT();
+}
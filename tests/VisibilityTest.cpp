@@ -0,0 +1,167 @@
+//  U8Widget - Simple widget library based on U8g2 by olikraus
+//  Copyright (C) 2024  Tamas Karpati
+//
+//  This program is free software: you can redistribute it and/or modify
+//  it under the terms of the GNU General Public License as published by
+//  the Free Software Foundation, either version 3 of the License, or
+//  (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//  You should have received a copy of the GNU General Public License
+//  along with this program.  If not, see <https://www.gnu.org/licenses/>.#pragma once
+
+
+// Checks what hiding and showing widgets repaints, in both repaint modes
+
+#include "FrameBuffer.h"
+#include "HeadlessBackend.h"
+#include "Painter.h"
+#include "Test.h"
+#include "Widget.h"
+
+#include <initializer_list>
+
+using namespace U8W;
+
+namespace
+{
+
+// Paints itself black and counts its paints
+class Marker : public Widget
+{
+public:
+    using Widget::Widget;
+
+    int paints = 0;
+
+protected:
+    void paint() override
+    {
+        ++paints;
+        _display->setDrawColor(Display::Color::Black);
+        _display->fillRect(globalRect());
+    }
+};
+
+struct Fixture
+{
+    HeadlessBackend backend;
+    Display display{ backend };
+    Painter painter;
+    Widget root{ &display };
+    Widget panel{ &root };
+    Marker box{ &panel };
+    Marker inner{ &box };
+
+    explicit Fixture(const Painter::RepaintMode mode)
+    {
+        painter.setRepaintMode(mode);
+
+        root.setRect(Rect{ Point{}, display.size() });
+        panel.setRect(Rect{ 20, 20, 100, 80 });
+        box.setRect(Rect{ 10, 10, 40, 30 });
+        inner.setRect(Rect{ 5, 5, 10, 10 });
+
+        painter.renderWidget(&root);
+    }
+
+    bool render()
+    {
+        box.paints = 0;
+        inner.paints = 0;
+        Test::fillBlack(display);
+
+        return painter.renderWidget(&root);
+    }
+};
+
+void testHidingRepaintsParentArea(const Painter::RepaintMode mode)
+{
+    Fixture f{ mode };
+
+    f.box.setVisible(false);
+    CHECK(f.root.isRepaintPending());
+    CHECK(f.render());
+
+    CHECK_EQUAL(f.box.paints, 0);
+    CHECK_EQUAL(f.inner.paints, 0);
+
+    // The full mode repaints the whole parent, the damage mode only the
+    // area the box left
+    const Test::FrameBuffer pixels{ f.display };
+    const auto boxArea = Rect{ 30, 30, 40, 30 };
+
+    if (mode == Painter::RepaintMode::Full) {
+        CHECK(pixels.isWhiteExactly(Region{ Rect{ 20, 20, 100, 80 } }));
+    } else {
+        CHECK(pixels.isWhiteExactly(Region{ boxArea }));
+    }
+}
+
+void testHiddenSubtreeIsIgnored(const Painter::RepaintMode mode)
+{
+    Fixture f{ mode };
+
+    f.box.setVisible(false);
+    f.render();
+
+    // Changes in the hidden subtree mark nothing above it
+    f.inner.setBackgroundEnabled(true);
+    f.inner.setPos(Point{ 20, 10 });
+    f.box.setBackgroundEnabled(true);
+
+    CHECK(!f.root.isRepaintPending());
+    CHECK(!f.panel.isRepaintPending());
+    CHECK(!f.render());
+    CHECK_EQUAL(f.box.paints, 0);
+    CHECK_EQUAL(f.inner.paints, 0);
+    CHECK_EQUAL(Test::FrameBuffer{ f.display }.countWhite(), 0);
+
+    // Shown again, the subtree is painted once with its changes
+    f.box.setVisible(true);
+    CHECK(f.root.isRepaintPending());
+    CHECK(f.render());
+    CHECK_EQUAL(f.box.paints, 1);
+    CHECK_EQUAL(f.inner.paints, 1);
+
+    const Test::FrameBuffer pixels{ f.display };
+    CHECK_EQUAL(pixels.countWhite(Rect{ 30, 30, 40, 30 }), 0);
+    CHECK(!f.box.isRepaintPending());
+}
+
+void testHiddenAncestor(const Painter::RepaintMode mode)
+{
+    Fixture f{ mode };
+
+    // The box is visible itself, but its parent is hidden
+    f.panel.setVisible(false);
+    f.render();
+
+    f.box.setBackgroundEnabled(true);
+
+    CHECK(!f.root.isRepaintPending());
+    CHECK(!f.render());
+    CHECK_EQUAL(f.box.paints, 0);
+
+    f.panel.setVisible(true);
+    CHECK(f.render());
+    CHECK_EQUAL(f.box.paints, 1);
+    CHECK_EQUAL(f.inner.paints, 1);
+}
+
+}
+
+int main()
+{
+    for (const auto mode : { Painter::RepaintMode::Full, Painter::RepaintMode::Damage }) {
+        testHidingRepaintsParentArea(mode);
+        testHiddenSubtreeIsIgnored(mode);
+        testHiddenAncestor(mode);
+    }
+
+    return TEST_RESULT();
+}